@@ -0,0 +1,66 @@
+#include "alloc_counter.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace insights::bench {
+
+AllocationCounters &allocationCounters() {
+  static AllocationCounters Counters;
+  return Counters;
+}
+
+} // namespace insights::bench
+
+namespace {
+
+void *countedAllocate(std::size_t Size) {
+  auto &Counters = insights::bench::allocationCounters();
+  Counters.Allocations.fetch_add(1, std::memory_order_relaxed);
+  Counters.Bytes.fetch_add(Size, std::memory_order_relaxed);
+  if (void *Ptr = std::malloc(Size == 0 ? 1 : Size)) {
+    return Ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+// std::pmr::new_delete_resource allocates through the aligned overloads.
+void *countedAllocate(std::size_t Size, std::align_val_t Align) {
+  auto &Counters = insights::bench::allocationCounters();
+  Counters.Allocations.fetch_add(1, std::memory_order_relaxed);
+  Counters.Bytes.fetch_add(Size, std::memory_order_relaxed);
+  auto Alignment = static_cast<std::size_t>(Align);
+  auto Rounded = (std::max<std::size_t>(Size, 1) + Alignment - 1) /
+                 Alignment * Alignment;
+  if (void *Ptr = std::aligned_alloc(Alignment, Rounded)) {
+    return Ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+} // namespace
+
+void *operator new(std::size_t Size) { return countedAllocate(Size); }
+void *operator new[](std::size_t Size) { return countedAllocate(Size); }
+void operator delete(void *Ptr) noexcept { std::free(Ptr); }
+void operator delete[](void *Ptr) noexcept { std::free(Ptr); }
+void operator delete(void *Ptr, std::size_t) noexcept { std::free(Ptr); }
+void operator delete[](void *Ptr, std::size_t) noexcept { std::free(Ptr); }
+
+void *operator new(std::size_t Size, std::align_val_t Align) {
+  return countedAllocate(Size, Align);
+}
+void *operator new[](std::size_t Size, std::align_val_t Align) {
+  return countedAllocate(Size, Align);
+}
+void operator delete(void *Ptr, std::align_val_t) noexcept { std::free(Ptr); }
+void operator delete[](void *Ptr, std::align_val_t) noexcept {
+  std::free(Ptr);
+}
+void operator delete(void *Ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(Ptr);
+}
+void operator delete[](void *Ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(Ptr);
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace insights::bench {
+
+// Process-wide allocation counters, fed by the global operator new
+// replacement in alloc_counter.cpp. Benchmarks snapshot them around the
+// timed loop to report allocations and bytes per iteration.
+struct AllocationCounters {
+  std::atomic<uint64_t> Allocations{0};
+  std::atomic<uint64_t> Bytes{0};
+};
+
+AllocationCounters &allocationCounters();
+
+struct AllocationSample {
+  uint64_t Allocations{0};
+  uint64_t Bytes{0};
+
+  static AllocationSample now() {
+    auto &Counters = allocationCounters();
+    return {
+        .Allocations = Counters.Allocations.load(std::memory_order_relaxed),
+        .Bytes = Counters.Bytes.load(std::memory_order_relaxed),
+    };
+  }
+
+  AllocationSample operator-(const AllocationSample &Other) const {
+    return {
+        .Allocations = Allocations - Other.Allocations,
+        .Bytes = Bytes - Other.Bytes,
+    };
+  }
+};
+
+} // namespace insights::bench
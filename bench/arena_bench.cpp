@@ -0,0 +1,88 @@
+// Handler temporaries of a filtered list request (query-string decoding and
+// the snapshot scan's match vector) with and without the request arena,
+// single-threaded and across threads to show allocator contention.
+#include "alloc_counter.hpp"
+#include "fixtures.hpp"
+#include "insights/core/arena.hpp"
+#include "insights/core/list_query.hpp"
+#include "insights/github/models.hpp"
+
+#include <benchmark/benchmark.h>
+#include <glaze/net/http_router.hpp>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace {
+
+using insights::bench::AllocationSample;
+using insights::github::models::Repository;
+
+glz::request listRequest() {
+  glz::request Request{};
+  Request.method = glz::http_method::GET;
+  Request.path = "/repos";
+  Request.target = "/repos?min_stars=100&max_forks=250&sort=-stars&limit=50"
+                   "&fields=Name%2CStars%2CForks";
+  return Request;
+}
+
+// One request's worth of temporaries; the result is dropped at the end of
+// the call, as it would be when the handler returns.
+std::size_t handleList(
+    const glz::request &Request,
+    const std::vector<std::shared_ptr<const Repository>> &Repositories
+) {
+  auto Query = insights::core::parseListQuery<Repository>(Request);
+  std::pmr::vector<std::shared_ptr<const Repository>> Matching(
+      insights::core::requestResource()
+  );
+  for (const auto &Entity : Repositories) {
+    if (insights::core::matches(*Entity, *Query)) {
+      Matching.push_back(Entity);
+    }
+  }
+  return Matching.size();
+}
+
+// The counters are process-wide, so they are only per-iteration figures
+// when a single thread is running.
+void reportAllocations(
+    benchmark::State &State, const AllocationSample &Start
+) {
+  if (State.threads() != 1) {
+    return;
+  }
+  auto Delta = AllocationSample::now() - Start;
+  State.counters["allocs"] = benchmark::Counter(
+      static_cast<double>(Delta.Allocations), benchmark::Counter::kAvgIterations
+  );
+  State.counters["alloc_bytes"] = benchmark::Counter(
+      static_cast<double>(Delta.Bytes), benchmark::Counter::kAvgIterations
+  );
+}
+
+void BM_ListTemporariesGlobalHeap(benchmark::State &State) {
+  auto Repositories = insights::bench::makeRepositories(300);
+  auto Request = listRequest();
+  auto Start = AllocationSample::now();
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(handleList(Request, Repositories));
+  }
+  reportAllocations(State, Start);
+}
+BENCHMARK(BM_ListTemporariesGlobalHeap)->ThreadRange(1, 8);
+
+void BM_ListTemporariesRequestArena(benchmark::State &State) {
+  auto Repositories = insights::bench::makeRepositories(300);
+  auto Request = listRequest();
+  auto Start = AllocationSample::now();
+  for (auto _ : State) {
+    insights::core::RequestArena Arena;
+    benchmark::DoNotOptimize(handleList(Request, Repositories));
+  }
+  reportAllocations(State, Start);
+}
+BENCHMARK(BM_ListTemporariesRequestArena)->ThreadRange(1, 8);
+
+} // namespace
@@ -0,0 +1,41 @@
+// JSON vs BEVE on the repository list payload: encode time per format, with
+// the encoded payload size reported as a counter.
+#include "fixtures.hpp"
+#include "insights/core/json.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+void encodeRepositoryList(
+    benchmark::State &State, insights::core::MediaType Format
+) {
+  auto Repositories = insights::bench::makeRepositories(
+      static_cast<std::size_t>(State.range(0))
+  );
+  std::size_t PayloadBytes = 0;
+  for (auto _ : State) {
+    auto Body = insights::core::writeBody(Format, Repositories);
+    PayloadBytes = Body->size();
+    benchmark::DoNotOptimize(Body);
+  }
+  State.counters["payload_bytes"] =
+      benchmark::Counter(static_cast<double>(PayloadBytes));
+  State.SetBytesProcessed(
+      static_cast<int64_t>(State.iterations()) *
+      static_cast<int64_t>(PayloadBytes)
+  );
+}
+
+void BM_RepositoryListJson(benchmark::State &State) {
+  encodeRepositoryList(State, insights::core::MediaType::Json);
+}
+
+void BM_RepositoryListBeve(benchmark::State &State) {
+  encodeRepositoryList(State, insights::core::MediaType::Beve);
+}
+
+} // namespace
+
+BENCHMARK(BM_RepositoryListJson)->Arg(30)->Arg(300)->Arg(3000);
+BENCHMARK(BM_RepositoryListBeve)->Arg(30)->Arg(300)->Arg(3000);
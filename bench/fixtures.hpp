@@ -0,0 +1,49 @@
+#pragma once
+#include "insights/core/uuid.hpp"
+#include "insights/github/models.hpp"
+
+#include <cstddef>
+#include <format>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace insights::bench {
+
+// Deterministic synthetic entities sized like the production data set
+// (a few hundred repositories across a handful of accounts).
+inline std::string syntheticUuid(std::size_t Seed) {
+  return std::format(
+      "{:08x}-{:04x}-4{:03x}-8{:03x}-{:012x}",
+      static_cast<unsigned>(Seed * 2654435761u),
+      Seed % 0xffff,
+      Seed % 0xfff,
+      (Seed * 7) % 0xfff,
+      Seed * 11400714819323198485ull % 0xffffffffffffull
+  );
+}
+
+inline std::vector<std::shared_ptr<const github::models::Repository>>
+makeRepositories(std::size_t Count) {
+  std::vector<std::shared_ptr<const github::models::Repository>> Repositories;
+  Repositories.reserve(Count);
+  for (std::size_t I = 0; I < Count; ++I) {
+    Repositories.push_back(
+        std::make_shared<const github::models::Repository>(
+            github::models::Repository{
+                .Id = *core::Uuid::parse(syntheticUuid(I + 1)),
+                .Name = std::format("component-{}", I),
+                .AccountId = *core::Uuid::parse(syntheticUuid(I % 8 + 100000)),
+                .Clones = static_cast<int>(I * 13 % 5000),
+                .Forks = static_cast<int>(I * 7 % 300),
+                .Stars = static_cast<int>(I * 31 % 2000),
+                .Subscribers = static_cast<int>(I % 40),
+                .Views = static_cast<int>(I * 97 % 40000),
+            }
+        )
+    );
+  }
+  return Repositories;
+}
+
+} // namespace insights::bench
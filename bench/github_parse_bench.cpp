@@ -0,0 +1,119 @@
+// Parsing the GitHub API responses the sync task reads. Only a few fields
+// are kept from each body, so most of the cost is skipping unknown keys;
+// the bodies below follow the shape and size of the real responses.
+#include "insights/github/responses.hpp"
+
+#include <benchmark/benchmark.h>
+#include <format>
+#include <glaze/json/read.hpp>
+#include <string>
+#include <string_view>
+
+namespace {
+
+namespace responses = insights::github::tasks::responses;
+
+constexpr glz::opts ParseOpts{.error_on_unknown_keys = false};
+
+std::string ownerJson(std::string_view Login) {
+  return std::format(
+      R"({{"login":"{0}","id":1234567,)"
+      R"("node_id":"MDEyOk9yZ2FuaXphdGlvbjEyMzQ1Njc=",)"
+      R"("avatar_url":"https://avatars.githubusercontent.com/u/1234567?v=4",)"
+      R"("gravatar_id":"","url":"https://api.github.com/users/{0}",)"
+      R"("html_url":"https://github.com/{0}",)"
+      R"("repos_url":"https://api.github.com/users/{0}/repos",)"
+      R"("type":"Organization","site_admin":false}})",
+      Login
+  );
+}
+
+std::string repositoryJson() {
+  return std::format(
+      R"({{"id":987654321,"node_id":"R_kgDOJq7xYQ","name":"icicle-insights",)"
+      R"("full_name":"icicle-ai/icicle-insights","private":false,)"
+      R"("owner":{},"html_url":"https://github.com/icicle-ai/icicle-insights",)"
+      R"("description":"Usage insights for ICICLE components","fork":false,)"
+      R"("url":"https://api.github.com/repos/icicle-ai/icicle-insights",)"
+      R"("created_at":"2024-05-02T17:03:11Z",)"
+      R"("updated_at":"2026-10-01T08:12:45Z",)"
+      R"("pushed_at":"2026-09-30T21:44:02Z","homepage":null,"size":4812,)"
+      R"("stargazers_count":143,"watchers_count":143,"language":"C++",)"
+      R"("has_issues":true,"has_projects":true,"has_downloads":true,)"
+      R"("has_wiki":false,"has_pages":false,"has_discussions":false,)"
+      R"("forks_count":27,"mirror_url":null,"archived":false,"disabled":false,)"
+      R"("open_issues_count":9,"license":{{"key":"bsd-3-clause",)"
+      R"("name":"BSD 3-Clause \"New\" or \"Revised\" License",)"
+      R"("spdx_id":"BSD-3-Clause",)"
+      R"("url":"https://api.github.com/licenses/bsd-3-clause"}},)"
+      R"("allow_forking":true,"is_template":false,)"
+      R"("topics":["ai","cpp","insights","metrics"],"visibility":"public",)"
+      R"("forks":27,"open_issues":9,"watchers":143,"default_branch":"main",)"
+      R"("network_count":27,"subscribers_count":12}})",
+      ownerJson("icicle-ai")
+  );
+}
+
+std::string trafficJson() {
+  std::string Days;
+  for (int Day = 1; Day <= 14; ++Day) {
+    Days += std::format(
+        R"({}{{"timestamp":"2026-09-{:02}T00:00:00Z",)"
+        R"("count":{},"uniques":{}}})",
+        Day == 1 ? "" : ",",
+        Day,
+        Day * 7,
+        Day * 3
+    );
+  }
+  return std::format(R"({{"count":1204,"uniques":391,"views":[{}]}})", Days);
+}
+
+std::string organizationJson() {
+  return std::format(
+      R"({{"login":"icicle-ai","id":1234567,)"
+      R"("url":"https://api.github.com/orgs/icicle-ai",)"
+      R"("repos_url":"https://api.github.com/orgs/icicle-ai/repos",)"
+      R"("description":"Intelligent CyberInfrastructure","name":"ICICLE",)"
+      R"("company":null,"blog":"https://icicle.osu.edu","location":"Ohio",)"
+      R"("email":null,"twitter_username":null,"is_verified":true,)"
+      R"("has_organization_projects":true,"has_repository_projects":true,)"
+      R"("public_repos":86,"public_gists":0,"followers":{},"following":0,)"
+      R"("html_url":"https://github.com/icicle-ai",)"
+      R"("created_at":"2022-01-10T15:20:00Z",)"
+      R"("updated_at":"2026-08-19T11:02:31Z",)"
+      R"("archived_at":null,"type":"Organization"}})",
+      211
+  );
+}
+
+template <typename T>
+void parseBody(benchmark::State &State, const std::string &Body) {
+  for (auto _ : State) {
+    T Parsed{};
+    auto Error = glz::read<ParseOpts>(Parsed, Body);
+    benchmark::DoNotOptimize(Error);
+    benchmark::DoNotOptimize(Parsed);
+  }
+  State.SetBytesProcessed(
+      static_cast<int64_t>(State.iterations()) *
+      static_cast<int64_t>(Body.size())
+  );
+}
+
+void BM_ParseRepoStats(benchmark::State &State) {
+  parseBody<responses::GitHubRepoStatsResponse>(State, repositoryJson());
+}
+BENCHMARK(BM_ParseRepoStats);
+
+void BM_ParseRepoTraffic(benchmark::State &State) {
+  parseBody<responses::GitHubRepoTrafficResponse>(State, trafficJson());
+}
+BENCHMARK(BM_ParseRepoTraffic);
+
+void BM_ParseOrgStats(benchmark::State &State) {
+  parseBody<responses::GitHubOrgStatsResponse>(State, organizationJson());
+}
+BENCHMARK(BM_ParseOrgStats);
+
+} // namespace
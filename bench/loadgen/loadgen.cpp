@@ -0,0 +1,661 @@
+// Open-loop HTTP load generator for capacity planning.
+//
+// Requests are scheduled at a constant arrival rate, independent of how
+// fast the server answers: request i is due at Start + i / Rate, and its
+// latency is measured from that intended time, not from when a connection
+// became free to send it. A server that stalls therefore shows the queueing
+// delay it caused instead of silently lowering the offered load
+// (coordinated omission).
+//
+//   icicle-insights-loadgen --host 127.0.0.1 --port 3000 --rate 2000 \
+//       --duration 60 --connections 64 [--warmup 5] [--mix mix.json] \
+//       [--out report.json] [--seed 1]
+//
+// The mix file is a JSON array of routes, picked at random by Weight:
+//   [{"Name":"repos","Method":"GET","Path":"/api/github/repos","Weight":4},
+//    {"Name":"create","Method":"POST","Path":"/api/github/accounts",
+//     "Body":"{\"Name\":\"loadgen\"}","Weight":1}]
+// The report (stdout, or --out) is JSON with throughput, status counts and
+// p50/p90/p99/p999 latencies, overall and per route.
+#include "glaze/json/read.hpp"
+#include "glaze/json/write.hpp"
+
+#include <algorithm>
+#include <asio/connect.hpp>
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <asio/read.hpp>
+#include <asio/read_until.hpp>
+#include <asio/steady_timer.hpp>
+#include <asio/streambuf.hpp>
+#include <asio/write.hpp>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct RouteSpec {
+  std::string Name;
+  std::string Method{"GET"};
+  std::string Path;
+  std::string Body;
+  double Weight{1.0};
+};
+
+struct Options {
+  std::string Host{"127.0.0.1"};
+  std::string Port{"3000"};
+  double Rate{1000.0};
+  double DurationS{30.0};
+  double WarmupS{5.0};
+  std::size_t Connections{64};
+  std::optional<std::string> MixFile;
+  std::optional<std::string> OutFile;
+  uint32_t Seed{1};
+};
+
+// Read-only routes that exist on every deployment.
+std::vector<RouteSpec> defaultMix() {
+  return {
+      {.Name = "health", .Path = "/health", .Weight = 1},
+      {.Name = "accounts", .Path = "/api/github/accounts", .Weight = 2},
+      {.Name = "repos", .Path = "/api/github/repos", .Weight = 4},
+      {.Name = "repos-top",
+       .Path = "/api/github/repos?min_stars=10&sort=-stars&limit=20",
+       .Weight = 2},
+      {.Name = "stats", .Path = "/api/github/stats", .Weight = 1},
+  };
+}
+
+template <typename T> bool parseNumber(std::string_view Text, T &Value) {
+  auto [End, Ec] =
+      std::from_chars(Text.data(), Text.data() + Text.size(), Value);
+  return Ec == std::errc{} && End == Text.data() + Text.size();
+}
+
+std::optional<Options> parseOptions(int Argc, char **Argv) {
+  Options Opts;
+  for (int I = 1; I + 1 < Argc; I += 2) {
+    std::string_view Key = Argv[I];
+    std::string_view Value = Argv[I + 1];
+    bool Ok = true;
+    if (Key == "--host") {
+      Opts.Host = Value;
+    } else if (Key == "--port") {
+      Opts.Port = Value;
+    } else if (Key == "--rate") {
+      Ok = parseNumber(Value, Opts.Rate) && Opts.Rate > 0;
+    } else if (Key == "--duration") {
+      Ok = parseNumber(Value, Opts.DurationS) && Opts.DurationS > 0;
+    } else if (Key == "--warmup") {
+      Ok = parseNumber(Value, Opts.WarmupS) && Opts.WarmupS >= 0;
+    } else if (Key == "--connections") {
+      Ok = parseNumber(Value, Opts.Connections) && Opts.Connections > 0;
+    } else if (Key == "--mix") {
+      Opts.MixFile = std::string(Value);
+    } else if (Key == "--out") {
+      Opts.OutFile = std::string(Value);
+    } else if (Key == "--seed") {
+      Ok = parseNumber(Value, Opts.Seed);
+    } else {
+      Ok = false;
+    }
+    if (!Ok) {
+      std::fprintf(stderr, "Invalid option: %s %s\n", Argv[I], Argv[I + 1]);
+      return std::nullopt;
+    }
+  }
+  if (Argc % 2 == 0) {
+    std::fprintf(stderr, "Missing value for %s\n", Argv[Argc - 1]);
+    return std::nullopt;
+  }
+  return Opts;
+}
+
+std::optional<std::vector<RouteSpec>> loadMix(const Options &Opts) {
+  if (!Opts.MixFile) {
+    return defaultMix();
+  }
+  std::ifstream File(*Opts.MixFile);
+  if (!File) {
+    std::fprintf(stderr, "Cannot open mix file %s\n", Opts.MixFile->c_str());
+    return std::nullopt;
+  }
+  std::string Text{std::istreambuf_iterator<char>(File), {}};
+  std::vector<RouteSpec> Mix;
+  if (auto Error = glz::read_json(Mix, Text)) {
+    std::fprintf(
+        stderr, "Invalid mix file: %s\n", glz::format_error(Error, Text).c_str()
+    );
+    return std::nullopt;
+  }
+  if (Mix.empty()) {
+    std::fprintf(stderr, "Mix file has no routes\n");
+    return std::nullopt;
+  }
+  return Mix;
+}
+
+// Latencies in microseconds, kept exactly; a minute at 100k req/s is 24 MB.
+struct Samples {
+  std::vector<uint32_t> Micros;
+  uint64_t Ok{0};
+  uint64_t ClientErrors{0};
+  uint64_t ServerErrors{0};
+  uint64_t TransportErrors{0};
+
+  void record(Clock::duration Latency, int Status) {
+    if (Status == 0) {
+      ++TransportErrors;
+      return;
+    }
+    auto Us = std::chrono::duration_cast<std::chrono::microseconds>(Latency);
+    Micros.push_back(static_cast<uint32_t>(std::max<int64_t>(Us.count(), 0)));
+    if (Status >= 500) {
+      ++ServerErrors;
+    } else if (Status >= 400) {
+      ++ClientErrors;
+    } else {
+      ++Ok;
+    }
+  }
+};
+
+struct LatencyReport {
+  double P50{0};
+  double P90{0};
+  double P99{0};
+  double P999{0};
+  double Max{0};
+  double Mean{0};
+};
+
+struct RouteReport {
+  std::string Name;
+  uint64_t Completed{0};
+  uint64_t Ok{0};
+  uint64_t ClientErrors{0};
+  uint64_t ServerErrors{0};
+  uint64_t TransportErrors{0};
+  LatencyReport LatencyMs;
+};
+
+struct Report {
+  std::string Target;
+  double OfferedRate{0};
+  double DurationS{0};
+  std::size_t Connections{0};
+  uint64_t Scheduled{0};
+  uint64_t Completed{0};
+  uint64_t Unfinished{0};
+  double ThroughputRps{0};
+  RouteReport Total;
+  std::vector<RouteReport> Routes;
+};
+
+LatencyReport summarize(std::vector<uint32_t> &Micros) {
+  if (Micros.empty()) {
+    return {};
+  }
+  std::ranges::sort(Micros);
+  auto At = [&](double Quantile) {
+    auto Rank = static_cast<std::size_t>(
+        std::ceil(Quantile * static_cast<double>(Micros.size()))
+    );
+    return Micros[std::clamp<std::size_t>(Rank, 1, Micros.size()) - 1] / 1e3;
+  };
+  double Sum = 0;
+  for (auto Us : Micros) {
+    Sum += Us;
+  }
+  return {
+      .P50 = At(0.50),
+      .P90 = At(0.90),
+      .P99 = At(0.99),
+      .P999 = At(0.999),
+      .Max = Micros.back() / 1e3,
+      .Mean = Sum / static_cast<double>(Micros.size()) / 1e3,
+  };
+}
+
+RouteReport routeReport(std::string Name, Samples &Data) {
+  return {
+      .Name = std::move(Name),
+      .Completed = Data.Ok + Data.ClientErrors + Data.ServerErrors +
+                   Data.TransportErrors,
+      .Ok = Data.Ok,
+      .ClientErrors = Data.ClientErrors,
+      .ServerErrors = Data.ServerErrors,
+      .TransportErrors = Data.TransportErrors,
+      .LatencyMs = summarize(Data.Micros),
+  };
+}
+
+// One scheduled request: which route, and when it should have been sent.
+struct Scheduled {
+  std::size_t Route{0};
+  Clock::time_point Intended;
+  bool Measured{false};
+};
+
+struct Generator;
+
+// A keep-alive connection carrying one request at a time. It reconnects
+// lazily after an error or a "Connection: close" from the server.
+struct Connection : std::enable_shared_from_this<Connection> {
+  Connection(asio::io_context &Io, Generator &Owner)
+      : Socket(Io), Owner(Owner) {}
+
+  void send(Scheduled Request);
+
+private:
+  asio::ip::tcp::socket Socket;
+  Generator &Owner;
+  asio::streambuf Buffer;
+  std::string Out;
+  Scheduled Current;
+  bool Connected{false};
+
+  void write();
+  void readHead();
+  void finish(int Status, bool KeepAlive);
+  void fail();
+};
+
+struct Generator {
+  Generator(
+      asio::io_context &Io,
+      Options Opts,
+      std::vector<RouteSpec> Mix,
+      asio::ip::tcp::resolver::results_type Endpoints
+  )
+      : Io(Io), Opts(std::move(Opts)), Mix(std::move(Mix)),
+        Endpoints(std::move(Endpoints)), Timer(Io), Rng(this->Opts.Seed),
+        Pick(picker(this->Mix)), Results(this->Mix.size()) {
+    for (const auto &Route : this->Mix) {
+      Requests.push_back(requestText(Route));
+    }
+  }
+
+  void start() {
+    Start = Clock::now();
+    MeasureFrom = Start + toDuration(Opts.WarmupS);
+    End = MeasureFrom + toDuration(Opts.DurationS);
+    tick();
+  }
+
+  Report report() {
+    auto Measured = std::chrono::duration<double>(End - MeasureFrom).count();
+    Report Out{
+        .Target = std::format("{}:{}", Opts.Host, Opts.Port),
+        .OfferedRate = Opts.Rate,
+        .DurationS = Measured,
+        .Connections = Opts.Connections,
+        .Scheduled = MeasuredScheduled,
+        .Unfinished = MeasuredScheduled - MeasuredCompleted,
+    };
+    Samples All;
+    for (std::size_t I = 0; I < Mix.size(); ++I) {
+      auto &Data = Results[I];
+      All.Micros.insert(
+          All.Micros.end(), Data.Micros.begin(), Data.Micros.end()
+      );
+      All.Ok += Data.Ok;
+      All.ClientErrors += Data.ClientErrors;
+      All.ServerErrors += Data.ServerErrors;
+      All.TransportErrors += Data.TransportErrors;
+      Out.Routes.push_back(routeReport(Mix[I].Name, Data));
+    }
+    Out.Total = routeReport("total", All);
+    Out.Completed = Out.Total.Completed;
+    Out.ThroughputRps =
+        static_cast<double>(Out.Total.Ok + Out.Total.ClientErrors +
+                            Out.Total.ServerErrors) /
+        Measured;
+    return Out;
+  }
+
+private:
+  friend struct Connection;
+
+  // Requests still in flight this long after the run are reported as
+  // unfinished rather than waited for.
+  static constexpr auto DrainTimeout = std::chrono::seconds{5};
+
+  asio::io_context &Io;
+  Options Opts;
+  std::vector<RouteSpec> Mix;
+  asio::ip::tcp::resolver::results_type Endpoints;
+  std::vector<std::string> Requests;
+  asio::steady_timer Timer;
+  std::mt19937 Rng;
+  std::discrete_distribution<std::size_t> Pick;
+  std::vector<Samples> Results;
+
+  Clock::time_point Start;
+  Clock::time_point MeasureFrom;
+  Clock::time_point End;
+  uint64_t Issued{0};
+  uint64_t MeasuredScheduled{0};
+  uint64_t MeasuredCompleted{0};
+  std::size_t Open{0};
+  std::vector<std::shared_ptr<Connection>> Idle;
+  std::deque<Scheduled> Backlog;
+
+  static Clock::duration toDuration(double Seconds) {
+    return std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(Seconds)
+    );
+  }
+
+  static std::discrete_distribution<std::size_t>
+  picker(const std::vector<RouteSpec> &Mix) {
+    std::vector<double> Weights;
+    for (const auto &Route : Mix) {
+      Weights.push_back(Route.Weight);
+    }
+    return {Weights.begin(), Weights.end()};
+  }
+
+  std::string requestText(const RouteSpec &Route) const {
+    auto Text = std::format(
+        "{} {} HTTP/1.1\r\nHost: {}:{}\r\nAccept: application/json\r\n",
+        Route.Method,
+        Route.Path,
+        Opts.Host,
+        Opts.Port
+    );
+    if (!Route.Body.empty()) {
+      Text += std::format(
+          "Content-Type: application/json\r\nContent-Length: {}\r\n",
+          Route.Body.size()
+      );
+    }
+    Text += "\r\n";
+    Text += Route.Body;
+    return Text;
+  }
+
+  Clock::time_point intendedTime(uint64_t Index) const {
+    return Start + toDuration(static_cast<double>(Index) / Opts.Rate);
+  }
+
+  // Issues every request that is due, then sleeps until the next one.
+  // Timer lateness only delays sending; the intended times stay exact.
+  void tick() {
+    auto Now = Clock::now();
+    while (intendedTime(Issued) <= Now && intendedTime(Issued) < End) {
+      auto Intended = intendedTime(Issued++);
+      Scheduled Request{
+          .Route = Pick(Rng),
+          .Intended = Intended,
+          .Measured = Intended >= MeasureFrom,
+      };
+      MeasuredScheduled += Request.Measured ? 1 : 0;
+      dispatch(Request);
+    }
+    if (intendedTime(Issued) >= End) {
+      Timer.expires_at(End + DrainTimeout);
+      Timer.async_wait([this](const std::error_code &) { Io.stop(); });
+      return;
+    }
+    Timer.expires_at(intendedTime(Issued));
+    Timer.async_wait([this](const std::error_code &Ec) {
+      if (!Ec) {
+        tick();
+      }
+    });
+  }
+
+  void dispatch(const Scheduled &Request) {
+    if (!Idle.empty()) {
+      auto Conn = std::move(Idle.back());
+      Idle.pop_back();
+      Conn->send(Request);
+      return;
+    }
+    if (Open < Opts.Connections) {
+      ++Open;
+      std::make_shared<Connection>(Io, *this)->send(Request);
+      return;
+    }
+    // Every connection is busy: the request waits, and the wait counts
+    // towards its latency.
+    Backlog.push_back(Request);
+  }
+
+  void completed(
+      std::shared_ptr<Connection> Conn, const Scheduled &Request, int Status
+  ) {
+    if (Request.Measured) {
+      Results[Request.Route].record(Clock::now() - Request.Intended, Status);
+      ++MeasuredCompleted;
+    }
+    if (!Backlog.empty()) {
+      auto Next = Backlog.front();
+      Backlog.pop_front();
+      Conn->send(Next);
+      return;
+    }
+    Idle.push_back(std::move(Conn));
+    if (Issued > 0 && intendedTime(Issued) >= End &&
+        Idle.size() == Open) {
+      Io.stop();
+    }
+  }
+};
+
+void Connection::send(Scheduled Request) {
+  Current = Request;
+  Out = Owner.Requests[Request.Route];
+  if (Connected) {
+    write();
+    return;
+  }
+  asio::async_connect(
+      Socket,
+      Owner.Endpoints,
+      [Self = shared_from_this()](const std::error_code &Ec, const auto &) {
+        if (Ec) {
+          Self->fail();
+          return;
+        }
+        Self->Socket.set_option(asio::ip::tcp::no_delay(true));
+        Self->Connected = true;
+        Self->write();
+      }
+  );
+}
+
+void Connection::write() {
+  asio::async_write(
+      Socket,
+      asio::buffer(Out),
+      [Self = shared_from_this()](const std::error_code &Ec, std::size_t) {
+        if (Ec) {
+          Self->fail();
+          return;
+        }
+        Self->readHead();
+      }
+  );
+}
+
+void Connection::readHead() {
+  asio::async_read_until(
+      Socket,
+      Buffer,
+      "\r\n\r\n",
+      [Self = shared_from_this()](const std::error_code &Ec, std::size_t Size) {
+        if (Ec) {
+          Self->fail();
+          return;
+        }
+        std::string Head(
+            asio::buffers_begin(Self->Buffer.data()),
+            asio::buffers_begin(Self->Buffer.data()) +
+                static_cast<std::ptrdiff_t>(Size)
+        );
+        Self->Buffer.consume(Size);
+
+        int Status = 0;
+        std::size_t Length = 0;
+        bool HasLength = false;
+        bool KeepAlive = true;
+        std::istringstream Lines(Head);
+        std::string Line;
+        if (std::getline(Lines, Line) && Line.size() > 12) {
+          parseNumber(std::string_view(Line).substr(9, 3), Status);
+        }
+        while (std::getline(Lines, Line)) {
+          if (!Line.empty() && Line.back() == '\r') {
+            Line.pop_back();
+          }
+          auto Colon = Line.find(':');
+          if (Colon == std::string::npos) {
+            continue;
+          }
+          std::string Name = Line.substr(0, Colon);
+          std::ranges::transform(Name, Name.begin(), [](unsigned char Ch) {
+            return static_cast<char>(std::tolower(Ch));
+          });
+          auto Value = std::string_view(Line).substr(Colon + 1);
+          while (!Value.empty() && Value.front() == ' ') {
+            Value.remove_prefix(1);
+          }
+          if (Name == "content-length") {
+            HasLength = parseNumber(Value, Length);
+          } else if (Name == "connection" &&
+                     (Value == "close" || Value == "Close")) {
+            KeepAlive = false;
+          }
+        }
+        if (Status == 0 || !HasLength) {
+          // Chunked or malformed responses are not expected from the
+          // server; treat them as transport errors.
+          Self->fail();
+          return;
+        }
+
+        auto Buffered = Self->Buffer.size();
+        auto Missing = Length > Buffered ? Length - Buffered : 0;
+        asio::async_read(
+            Self->Socket,
+            Self->Buffer,
+            asio::transfer_exactly(Missing),
+            [Self, Status, Length, KeepAlive](
+                const std::error_code &Ec, std::size_t
+            ) {
+              if (Ec) {
+                Self->fail();
+                return;
+              }
+              Self->Buffer.consume(Length);
+              Self->finish(Status, KeepAlive);
+            }
+        );
+      }
+  );
+}
+
+void Connection::finish(int Status, bool KeepAlive) {
+  if (!KeepAlive) {
+    std::error_code Ignored;
+    Socket.close(Ignored);
+    Connected = false;
+    Buffer.consume(Buffer.size());
+  }
+  Owner.completed(shared_from_this(), Current, Status);
+}
+
+void Connection::fail() {
+  std::error_code Ignored;
+  Socket.close(Ignored);
+  Connected = false;
+  Buffer.consume(Buffer.size());
+  Owner.completed(shared_from_this(), Current, 0);
+}
+
+} // namespace
+
+int main(int Argc, char **Argv) {
+  auto Opts = parseOptions(Argc, Argv);
+  if (!Opts) {
+    return 2;
+  }
+  auto Mix = loadMix(*Opts);
+  if (!Mix) {
+    return 2;
+  }
+
+  asio::io_context Io;
+  asio::ip::tcp::resolver Resolver(Io);
+  std::error_code Ec;
+  auto Endpoints = Resolver.resolve(Opts->Host, Opts->Port, Ec);
+  if (Ec) {
+    std::fprintf(
+        stderr, "Cannot resolve %s: %s\n", Opts->Host.c_str(),
+        Ec.message().c_str()
+    );
+    return 1;
+  }
+
+  Generator Load(Io, *Opts, std::move(*Mix), Endpoints);
+  std::fprintf(
+      stderr,
+      "Offering %.0f req/s to %s:%s for %.0fs (+%.0fs warmup) over up to %zu "
+      "connections\n",
+      Opts->Rate,
+      Opts->Host.c_str(),
+      Opts->Port.c_str(),
+      Opts->DurationS,
+      Opts->WarmupS,
+      Opts->Connections
+  );
+  Load.start();
+  Io.run();
+
+  auto Result = Load.report();
+  std::string Json;
+  if (auto Error = glz::write<glz::opts{.prettify = true}>(Result, Json)) {
+    std::fprintf(stderr, "Failed to write report\n");
+    return 1;
+  }
+  if (Opts->OutFile) {
+    std::ofstream(*Opts->OutFile) << Json << '\n';
+  } else {
+    std::cout << Json << '\n';
+  }
+  std::fprintf(
+      stderr,
+      "%.0f req/s, p50 %.2fms p99 %.2fms p999 %.2fms, %llu errors\n",
+      Result.ThroughputRps,
+      Result.Total.LatencyMs.P50,
+      Result.Total.LatencyMs.P99,
+      Result.Total.LatencyMs.P999,
+      static_cast<unsigned long long>(
+          Result.Total.ServerErrors + Result.Total.TransportErrors
+      )
+  );
+  return 0;
+}
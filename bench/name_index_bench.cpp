@@ -0,0 +1,71 @@
+// Name lookups for GET /repos/by-name: a probe into the snapshot's
+// open-addressing index against the linear scan over every repository that
+// clients (and a naive handler) would otherwise do, plus the per-write cost
+// of copying the index into the next snapshot version.
+#include "fixtures.hpp"
+#include "insights/core/flat_index.hpp"
+#include "insights/github/models.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <format>
+#include <string>
+
+namespace {
+
+using insights::github::models::Repository;
+
+insights::core::FlatIndex<Repository> makeIndex(
+    const std::vector<std::shared_ptr<const Repository>> &Repositories
+) {
+  insights::core::FlatIndex<Repository> Index;
+  Index.reserve(Repositories.size());
+  for (const auto &Entry : Repositories) {
+    Index.insert(insights::core::hashLower(Entry->Name), Entry.get());
+  }
+  return Index;
+}
+
+void BM_NameIndexLookup(benchmark::State &State) {
+  auto Repositories = insights::bench::makeRepositories(State.range(0));
+  auto Index = makeIndex(Repositories);
+  // Mixed case, as clients send it.
+  auto Name = std::format("Component-{}", State.range(0) / 2);
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(Index.find(
+        insights::core::hashLower(Name),
+        [&](const Repository &Entry) {
+          return insights::core::equalsLower(Entry.Name, Name);
+        }
+    ));
+  }
+}
+BENCHMARK(BM_NameIndexLookup)->Arg(300)->Arg(10000);
+
+void BM_NameLinearScan(benchmark::State &State) {
+  auto Repositories = insights::bench::makeRepositories(State.range(0));
+  auto Name = std::format("Component-{}", State.range(0) / 2);
+  for (auto _ : State) {
+    const Repository *Found = nullptr;
+    for (const auto &Entry : Repositories) {
+      if (insights::core::equalsLower(Entry->Name, Name)) {
+        Found = Entry.get();
+        break;
+      }
+    }
+    benchmark::DoNotOptimize(Found);
+  }
+}
+BENCHMARK(BM_NameLinearScan)->Arg(300)->Arg(10000);
+
+void BM_NameIndexCopy(benchmark::State &State) {
+  auto Repositories = insights::bench::makeRepositories(State.range(0));
+  auto Index = makeIndex(Repositories);
+  for (auto _ : State) {
+    auto Copy = Index;
+    benchmark::DoNotOptimize(Copy);
+  }
+}
+BENCHMARK(BM_NameIndexCopy)->Arg(300)->Arg(10000);
+
+} // namespace
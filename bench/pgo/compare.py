@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+"""Compare two Google Benchmark JSON outputs (--benchmark_out).
+
+    compare.py baseline.json optimized.json
+
+Prints the CPU time of every benchmark present in both files, the speedup
+(baseline / optimized, >1 is faster) and the geometric mean speedup. With
+--benchmark_repetitions the median aggregate is compared; otherwise the
+single iteration run.
+"""
+
+import json
+import math
+import sys
+
+UNITS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load(path):
+    with open(path) as f:
+        runs = json.load(f)["benchmarks"]
+    medians = {
+        r["run_name"]: r
+        for r in runs
+        if r.get("run_type") == "aggregate" and r.get("aggregate_name") == "median"
+    }
+    times = {}
+    for r in runs:
+        name = r.get("run_name", r["name"])
+        if name in times:
+            continue
+        if medians:
+            r = medians.get(name)
+            if r is None:
+                continue
+        elif r.get("run_type") == "aggregate":
+            continue
+        times[name] = r["cpu_time"] * UNITS[r.get("time_unit", "ns")]
+    return times
+
+
+def fmt(ns):
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if ns >= scale:
+            return f"{ns / scale:.2f} {unit}"
+    return f"{ns:.1f} ns"
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit("usage: compare.py baseline.json optimized.json")
+    base, opt = load(sys.argv[1]), load(sys.argv[2])
+    names = [n for n in base if n in opt]
+    if not names:
+        sys.exit("no benchmarks in common")
+
+    width = max(len(n) for n in names)
+    print(f"{'benchmark':<{width}}  {'baseline':>12}  {'optimized':>12}  speedup")
+    logs = []
+    for name in names:
+        speedup = base[name] / opt[name]
+        logs.append(math.log(speedup))
+        print(
+            f"{name:<{width}}  {fmt(base[name]):>12}  {fmt(opt[name]):>12}"
+            f"  {speedup:6.3f}x"
+        )
+    geomean = math.exp(sum(logs) / len(logs))
+    print(f"\ngeomean speedup over {len(names)} benchmarks: {geomean:.3f}x")
+
+
+if __name__ == "__main__":
+    main()
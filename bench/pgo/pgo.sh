@@ -0,0 +1,128 @@
+#!/usr/bin/env bash
+# LTO + profile-guided optimization cycle (`just pgo`).
+#
+#   1. baseline:     plain Release build of the benchmarks and the load
+#                    generator, and an LTO-only build of the benchmarks.
+#   2. instrumented: LTO server built with INSIGHTS_PGO=GENERATE.
+#   3. training:     the instrumented server runs against DATABASE_URL with
+#                    the GitHub sync and the per-client rate limits
+#                    disabled (every loadgen request comes from 127.0.0.1,
+#                    so the limits would otherwise train the 429 path)
+#                    while the load generator replays
+#                    bench/pgo/training-mix.json: the read routes plus bulk
+#                    account and repository upserts standing in for the
+#                    sync's write path. SIGTERM flushes the profile.
+#   4. optimized:    the same build directory reconfigured with
+#                    INSIGHTS_PGO=USE.
+#   5. report:       the benchmark suite in all three builds, compared by
+#                    compare.py twice: LTO against the plain baseline, then
+#                    LTO + PGO against LTO alone, so the PGO gain is not
+#                    credited with what LTO did. The JSON results stay in
+#                    build-pgo/.
+#
+# Use a scratch database: training upserts pgo-* accounts and repositories.
+# PGO_PORT (default 18090), PGO_RATE (500/s) and PGO_DURATION (60s) tune the
+# training run.
+set -euo pipefail
+
+ROOT="$(cd "$(dirname "$0")/../.." && pwd)"
+DEPS="${CONAN_DEPS_DIR:-build/conan}"
+OUT="$ROOT/build-pgo"
+PROFILE_DIR="$OUT/profile"
+PORT="${PGO_PORT:-18090}"
+RATE="${PGO_RATE:-500}"
+DURATION="${PGO_DURATION:-60}"
+
+: "${DATABASE_URL:?DATABASE_URL is required for the training run}"
+
+configure() {
+    local Dir="$1"
+    shift
+    cmake -S "$ROOT" -B "$Dir" -G Ninja \
+        -DCMAKE_TOOLCHAIN_FILE="$ROOT/$DEPS/conan_toolchain.cmake" \
+        -DCMAKE_BUILD_TYPE=Release \
+        -DINSIGHTS_BUILD_BENCHMARKS=ON \
+        -DINSIGHTS_BUILD_LOADGEN=ON \
+        "$@"
+}
+
+echo "== baseline build"
+configure "$OUT/baseline"
+cmake --build "$OUT/baseline" \
+    --target icicle-insights-bench icicle-insights-loadgen
+
+echo "== LTO-only build"
+configure "$OUT/lto" -DINSIGHTS_ENABLE_LTO=ON
+cmake --build "$OUT/lto" --target icicle-insights-bench
+
+echo "== instrumented build"
+rm -rf "$PROFILE_DIR"
+mkdir -p "$PROFILE_DIR"
+configure "$OUT/pgo" \
+    -DINSIGHTS_ENABLE_LTO=ON \
+    -DINSIGHTS_PGO=GENERATE \
+    -DINSIGHTS_PGO_DIR="$PROFILE_DIR"
+cmake --build "$OUT/pgo" --target icicle-insights
+
+echo "== training run (${DURATION}s at ${RATE} req/s)"
+HOST=127.0.0.1 PORT="$PORT" LOG_LEVEL=warn GITHUB_SYNC_ENABLED=0 \
+    RATE_LIMIT_READ_BURST=0 RATE_LIMIT_WRITE_BURST=0 \
+    RATE_LIMIT_EXPENSIVE_BURST=0 \
+    GITHUB_TOKEN="${GITHUB_TOKEN:-unused}" "$OUT/pgo/icicle-insights" &
+SERVER=$!
+trap 'kill "$SERVER" 2>/dev/null || true' EXIT
+
+# The listener comes up before the warm-up; writes are refused until /ready.
+for _ in $(seq 1 300); do
+    curl -sf "http://127.0.0.1:$PORT/ready" >/dev/null && break
+    sleep 0.1
+done
+
+# The repository upserts need an owner; the bulk route returns the existing
+# account's id on later runs.
+ACCOUNT_ID=$(
+    curl -sf -X POST "http://127.0.0.1:$PORT/api/github/accounts:bulk" \
+        -d '[{"Name":"pgo-training"}]' |
+        python3 -c 'import json, sys; print(json.load(sys.stdin)["Results"][0]["Id"])'
+)
+sed "s/@ACCOUNT_ID@/$ACCOUNT_ID/g" "$ROOT/bench/pgo/training-mix.json" \
+    >"$PROFILE_DIR/training-mix.json"
+
+"$OUT/baseline/icicle-insights-loadgen" \
+    --port "$PORT" \
+    --rate "$RATE" \
+    --duration "$DURATION" \
+    --warmup 0 \
+    --mix "$PROFILE_DIR/training-mix.json" \
+    --out "$OUT/training-report.json"
+
+kill -TERM "$SERVER"
+wait "$SERVER" || true
+trap - EXIT
+
+if compgen -G "$PROFILE_DIR/*.profraw" >/dev/null; then
+    llvm-profdata merge \
+        -output="$PROFILE_DIR/insights.profdata" "$PROFILE_DIR"/*.profraw
+fi
+
+echo "== optimized build"
+configure "$OUT/pgo" -DINSIGHTS_PGO=USE
+cmake --build "$OUT/pgo" --target icicle-insights icicle-insights-bench
+
+echo "== benchmarks"
+for Build in baseline lto pgo; do
+    "$OUT/$Build/icicle-insights-bench" \
+        --benchmark_repetitions=5 \
+        --benchmark_out="$OUT/bench-$Build.json" \
+        --benchmark_out_format=json >/dev/null
+done
+
+echo "== LTO vs baseline"
+python3 "$ROOT/bench/pgo/compare.py" \
+    "$OUT/bench-baseline.json" "$OUT/bench-lto.json"
+# With GCC the profile covers the server's objects only, not the benchmark
+# binary's own, so expect this to stay near 1.0x there; with Clang it
+# also reflects header-only code the training run exercised.
+echo "== LTO + PGO vs LTO"
+python3 "$ROOT/bench/pgo/compare.py" \
+    "$OUT/bench-lto.json" "$OUT/bench-pgo.json"
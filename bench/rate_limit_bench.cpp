@@ -0,0 +1,57 @@
+// Per-request cost of the rate limiter: a hot client (shared-lock lookup
+// plus one CAS), a rotating set of clients spread over the shards, and the
+// hot path under thread contention.
+#include "insights/server/middleware/rate_limit.hpp"
+
+#include <benchmark/benchmark.h>
+#include <format>
+#include <string>
+#include <vector>
+
+namespace {
+
+using insights::server::middleware::RateLimiter;
+using insights::server::middleware::RateLimits;
+using insights::server::middleware::RatePolicy;
+using insights::server::middleware::RouteClass;
+
+// Generous enough that every request is allowed; the bench measures the
+// bookkeeping, not rejections.
+RateLimits unlimited() {
+  return RateLimits{
+      .Read = RatePolicy{.Burst = 1'000'000'000, .PerSecond = 1e9},
+  };
+}
+
+void BM_RateLimitSingleClient(benchmark::State &State) {
+  RateLimiter Limiter(unlimited());
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(Limiter.admit("10.0.0.1", RouteClass::Read));
+  }
+}
+BENCHMARK(BM_RateLimitSingleClient);
+
+void BM_RateLimitManyClients(benchmark::State &State) {
+  RateLimiter Limiter(unlimited());
+  std::vector<std::string> Clients;
+  for (int64_t I = 0; I < State.range(0); ++I) {
+    Clients.push_back(std::format("10.0.{}.{}", I / 256, I % 256));
+  }
+  std::size_t Next = 0;
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(Limiter.admit(Clients[Next], RouteClass::Read));
+    Next = Next + 1 == Clients.size() ? 0 : Next + 1;
+  }
+}
+BENCHMARK(BM_RateLimitManyClients)->Arg(64)->Arg(4096);
+
+void BM_RateLimitContended(benchmark::State &State) {
+  static RateLimiter Limiter(unlimited());
+  auto Client = std::format("10.1.0.{}", State.thread_index());
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(Limiter.admit(Client, RouteClass::Read));
+  }
+}
+BENCHMARK(BM_RateLimitContended)->ThreadRange(1, 16)->UseRealTime();
+
+} // namespace
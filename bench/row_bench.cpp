@@ -0,0 +1,108 @@
+// Row decoding: DbTraits<T>::fromRow over rows shaped like the ones the
+// repositories' SELECTs return. Every column goes through the same
+// pqxx::from_string conversions and core::parseTimestamp calls as a real
+// pqxx::row; only the libpq result storage is replaced, since a
+// pqxx::result cannot be built without a connection.
+#include "fixtures.hpp"
+#include "insights/core/traits.hpp"
+#include "insights/github/models.hpp"
+
+#include <benchmark/benchmark.h>
+#include <format>
+#include <pqxx/pqxx>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct SyntheticField {
+  const std::string *Value;
+
+  bool is_null() const { return Value == nullptr; }
+
+  template <typename T> T as() const { return pqxx::from_string<T>(*Value); }
+};
+
+// Text columns looked up by name, as pqxx::row::operator[] does; a column
+// that is not present reads as NULL (deleted_at on live entities).
+struct SyntheticRow {
+  std::vector<std::pair<std::string_view, std::string>> Columns;
+
+  SyntheticField operator[](std::string_view Name) const {
+    for (const auto &[Column, Value] : Columns) {
+      if (Column == Name) {
+        return {&Value};
+      }
+    }
+    return {nullptr};
+  }
+};
+
+std::vector<SyntheticRow> accountRows(std::size_t Count) {
+  std::vector<SyntheticRow> Rows;
+  Rows.reserve(Count);
+  for (std::size_t I = 0; I < Count; ++I) {
+    Rows.push_back({.Columns = {
+                        {"id", insights::bench::syntheticUuid(I + 100000)},
+                        {"name", std::format("account-{}", I)},
+                        {"followers", std::to_string(I * 17 % 900)},
+                        {"created_at", "2025-03-14 09:26:53.589793+00"},
+                        {"updated_at", "2026-10-01 12:00:00.000000+00"},
+                    }});
+  }
+  return Rows;
+}
+
+std::vector<SyntheticRow> repositoryRows(std::size_t Count) {
+  std::vector<SyntheticRow> Rows;
+  Rows.reserve(Count);
+  for (std::size_t I = 0; I < Count; ++I) {
+    Rows.push_back({.Columns = {
+                        {"id", insights::bench::syntheticUuid(I + 1)},
+                        {"name", std::format("component-{}", I)},
+                        {"account_id",
+                         insights::bench::syntheticUuid(I % 8 + 100000)},
+                        {"clones", std::to_string(I * 13 % 5000)},
+                        {"forks", std::to_string(I * 7 % 300)},
+                        {"stars", std::to_string(I * 31 % 2000)},
+                        {"subscribers", std::to_string(I % 40)},
+                        {"views", std::to_string(I * 97 % 40000)},
+                        {"created_at", "2025-03-14 09:26:53.589793+00"},
+                        {"updated_at", "2026-10-01 12:00:00.000000+00"},
+                    }});
+  }
+  return Rows;
+}
+
+template <typename T>
+void decodeRows(
+    benchmark::State &State, const std::vector<SyntheticRow> &Rows
+) {
+  for (auto _ : State) {
+    for (const auto &Row : Rows) {
+      auto Entity = insights::core::DbTraits<T>::fromRow(Row);
+      benchmark::DoNotOptimize(Entity);
+    }
+  }
+  State.SetItemsProcessed(
+      static_cast<int64_t>(State.iterations()) *
+      static_cast<int64_t>(Rows.size())
+  );
+}
+
+void BM_AccountFromRow(benchmark::State &State) {
+  auto Rows = accountRows(static_cast<std::size_t>(State.range(0)));
+  decodeRows<insights::github::models::Account>(State, Rows);
+}
+
+void BM_RepositoryFromRow(benchmark::State &State) {
+  auto Rows = repositoryRows(static_cast<std::size_t>(State.range(0)));
+  decodeRows<insights::github::models::Repository>(State, Rows);
+}
+
+} // namespace
+
+BENCHMARK(BM_AccountFromRow)->Arg(8)->Arg(300);
+BENCHMARK(BM_RepositoryFromRow)->Arg(30)->Arg(300)->Arg(3000);
@@ -0,0 +1,104 @@
+// Type-ahead queries for GET /search: the SearchIndex's sorted-name prefix
+// range and trigram postings against the linear lowercase-and-find scan an
+// in-memory ILIKE '%q%' amounts to, plus the cost of applying a write.
+#include "fixtures.hpp"
+#include "insights/github/models.hpp"
+#include "insights/github/search.hpp"
+#include "insights/github/snapshot.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <format>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using insights::github::SearchIndex;
+using insights::github::models::Repository;
+
+constexpr std::size_t Limit = 10;
+
+std::unique_ptr<SearchIndex> makeIndex(std::size_t Count) {
+  insights::github::Snapshot Current;
+  Current.Repositories = insights::bench::makeRepositories(Count);
+  auto Index = std::make_unique<SearchIndex>();
+  Index->load(Current);
+  return Index;
+}
+
+// A handful of matches.
+void BM_SearchPrefix(benchmark::State &State) {
+  auto Index = makeIndex(State.range(0));
+  auto Query = std::format("Component-{}", State.range(0) / 20);
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(Index->search(Query, Limit));
+  }
+}
+BENCHMARK(BM_SearchPrefix)->Arg(300)->Arg(10000);
+
+// Every name matches; ranking dominates.
+void BM_SearchBroadPrefix(benchmark::State &State) {
+  auto Index = makeIndex(State.range(0));
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(Index->search("comp", Limit));
+  }
+}
+BENCHMARK(BM_SearchBroadPrefix)->Arg(300)->Arg(10000);
+
+// A misspelling: no prefix match, trigram postings only.
+void BM_SearchFuzzy(benchmark::State &State) {
+  auto Index = makeIndex(State.range(0));
+  auto Query = std::format("compnent-{}", State.range(0) / 20);
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(Index->search(Query, Limit));
+  }
+}
+BENCHMARK(BM_SearchFuzzy)->Arg(300)->Arg(10000);
+
+void BM_SearchLinearScan(benchmark::State &State) {
+  auto Repositories = insights::bench::makeRepositories(State.range(0));
+  auto Query = insights::github::lowerName(
+      std::format("ponent-{}", State.range(0) / 20)
+  );
+  for (auto _ : State) {
+    std::vector<const Repository *> Matches;
+    for (const auto &Entry : Repositories) {
+      if (insights::github::lowerName(Entry->Name).find(Query) !=
+          std::string::npos) {
+        Matches.push_back(Entry.get());
+      }
+    }
+    auto Ranked = std::min(Limit, Matches.size());
+    std::partial_sort(
+        Matches.begin(),
+        Matches.begin() + static_cast<std::ptrdiff_t>(Ranked),
+        Matches.end(),
+        [](const Repository *A, const Repository *B) {
+          return A->Stars > B->Stars;
+        }
+    );
+    Matches.resize(Ranked);
+    benchmark::DoNotOptimize(Matches);
+  }
+}
+BENCHMARK(BM_SearchLinearScan)->Arg(300)->Arg(10000);
+
+// A write that renames one repository back and forth, so every iteration
+// moves it in the sorted array and the postings.
+void BM_SearchApplyRename(benchmark::State &State) {
+  auto Index = makeIndex(State.range(0));
+  auto Renamed = *insights::bench::makeRepositories(State.range(0)).front();
+  auto Original = Renamed.Name;
+  bool Flip = false;
+  for (auto _ : State) {
+    Renamed.Name = Flip ? Original : "renamed-component";
+    Flip = !Flip;
+    Index->apply(Renamed);
+  }
+}
+BENCHMARK(BM_SearchApplyRename)->Arg(300)->Arg(10000);
+
+} // namespace
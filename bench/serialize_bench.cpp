@@ -0,0 +1,95 @@
+// Repository list serialization: the old route path (copy every model into
+// an OutputRepositorySchema vector, then serialize into a fresh string)
+// against serializing the snapshot directly through the models' glz::meta
+// projection into the per-thread JSON buffer, plus the single-entity
+// response of GET /repos/{id}.
+#include "alloc_counter.hpp"
+#include "fixtures.hpp"
+#include "insights/core/json.hpp"
+#include "insights/github/routes.hpp"
+
+#include <benchmark/benchmark.h>
+#include <glaze/json/write.hpp>
+#include <string>
+#include <vector>
+
+namespace {
+
+using insights::bench::AllocationSample;
+
+void reportAllocations(
+    benchmark::State &State, const AllocationSample &Start, std::size_t Bytes
+) {
+  auto Delta = AllocationSample::now() - Start;
+  State.counters["allocs"] = benchmark::Counter(
+      static_cast<double>(Delta.Allocations), benchmark::Counter::kAvgIterations
+  );
+  State.counters["alloc_bytes"] = benchmark::Counter(
+      static_cast<double>(Delta.Bytes), benchmark::Counter::kAvgIterations
+  );
+  State.SetBytesProcessed(
+      static_cast<int64_t>(State.iterations()) * static_cast<int64_t>(Bytes)
+  );
+}
+
+void BM_RepositoryListCopyToSchema(benchmark::State &State) {
+  auto Repositories = insights::bench::makeRepositories(
+      static_cast<std::size_t>(State.range(0))
+  );
+  std::size_t Bytes = 0;
+  auto Start = AllocationSample::now();
+  for (auto _ : State) {
+    std::vector<insights::github::OutputRepositorySchema> Output;
+    for (const auto &Repository : Repositories) {
+      Output.emplace_back(
+          insights::github::OutputRepositorySchema{
+              .Id = Repository->Id,
+              .Name = Repository->Name,
+              .AccountId = Repository->AccountId,
+              .Clones = Repository->Clones,
+              .Forks = Repository->Forks,
+              .Stars = Repository->Stars,
+              .Subscribers = Repository->Subscribers,
+              .Views = Repository->Views,
+          }
+      );
+    }
+    std::string Body;
+    (void)glz::write_json(Output, Body);
+    Bytes = Body.size();
+    benchmark::DoNotOptimize(Body);
+  }
+  reportAllocations(State, Start, Bytes);
+}
+
+void BM_RepositoryListMetaProjection(benchmark::State &State) {
+  auto Repositories = insights::bench::makeRepositories(
+      static_cast<std::size_t>(State.range(0))
+  );
+  std::size_t Bytes = 0;
+  auto Start = AllocationSample::now();
+  for (auto _ : State) {
+    auto Body = insights::core::writeJson(Repositories);
+    Bytes = Body->size();
+    benchmark::DoNotOptimize(Body);
+  }
+  reportAllocations(State, Start, Bytes);
+}
+
+void BM_RepositorySingleMetaProjection(benchmark::State &State) {
+  auto Repositories = insights::bench::makeRepositories(1);
+  std::size_t Bytes = 0;
+  auto Start = AllocationSample::now();
+  for (auto _ : State) {
+    auto Body = insights::core::writeJson(*Repositories.front());
+    Bytes = Body->size();
+    benchmark::DoNotOptimize(Body);
+  }
+  reportAllocations(State, Start, Bytes);
+}
+
+} // namespace
+
+BENCHMARK(BM_RepositorySingleMetaProjection);
+BENCHMARK(BM_RepositoryListCopyToSchema)->Arg(30)->Arg(300)->Arg(3000);
+BENCHMARK(BM_RepositoryListMetaProjection)->Arg(30)->Arg(300)->Arg(3000);
@@ -0,0 +1,965 @@
+// In-process thread-scaling harness.
+//
+// Builds the full server with createApp and warmUp (the same middleware,
+// read state and routes as the service) against DATABASE_URL and serves it
+// on 127.0.0.1. For each thread count it runs the server's io_context on that
+// many threads while closed-loop clients drive a mixed load: list and
+// single-entity reads, stats, health checks (a database round trip) and
+// repository creates and deletes. Each client keeps one request in flight,
+// so throughput is what the server sustains at that thread count.
+//
+//   icicle-insights-stress [--threads 1,2,4,8] [--duration 10] [--warmup 2]
+//       [--clients 64] [--client-threads 2] [--writes 0.1] [--port 18089]
+//       [--seed-repos 300] [--out report.json]
+//
+// Reads the usual server environment (DATABASE_URL, GITHUB_TOKEN, ...);
+// point it at a scratch database. It seeds one "stress-..." account with
+// --seed-repos repositories and soft-deletes everything it created on exit.
+//
+// Before the first step it checks connection churn: MAX_CONNECTIONS + 1
+// connections opened one after another, each sending a single
+// "Connection: close" request. Closed connections must not keep counting
+// towards the cap, so any 503 there fails the run (exit status 1).
+//
+// The report (stdout, or --out) is JSON with one entry per thread count:
+// throughput, speedup and efficiency against the first step, status counts,
+// p50/p90/p99/p999 latencies overall and per route, process CPU time, and
+// how often each instrumented lock (core::LockRegistry) was found held and
+// for how long. Clients share the machine with the server, so keep
+// --client-threads small and read efficiency as a trend.
+#include "insights/core/config.hpp"
+#include "insights/core/contention.hpp"
+#include "insights/core/logging.hpp"
+#include "insights/github/models.hpp"
+#include "insights/github/state.hpp"
+#include "insights/server/server.hpp"
+
+#include "glaze/json/read.hpp"
+#include "glaze/json/write.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <array>
+#include <asio/connect.hpp>
+#include <asio/io_context.hpp>
+#include <asio/ip/tcp.hpp>
+#include <asio/post.hpp>
+#include <asio/read.hpp>
+#include <asio/read_until.hpp>
+#include <asio/steady_timer.hpp>
+#include <asio/streambuf.hpp>
+#include <asio/write.hpp>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using insights::github::models::Account;
+using insights::github::models::Repository;
+
+struct Options {
+  std::vector<std::size_t> Threads;
+  double DurationS{10.0};
+  double WarmupS{2.0};
+  std::size_t Clients{64};
+  std::size_t ClientThreads{2};
+  double WriteRatio{0.1};
+  int Port{18089};
+  std::size_t SeedRepositories{300};
+  std::optional<std::string> OutFile;
+};
+
+template <typename T> bool parseNumber(std::string_view Text, T &Value) {
+  auto [End, Ec] =
+      std::from_chars(Text.data(), Text.data() + Text.size(), Value);
+  return Ec == std::errc{} && End == Text.data() + Text.size();
+}
+
+// 1, 2, 4, ... up to the hardware thread count, which is always included.
+std::vector<std::size_t> defaultThreads() {
+  auto Max = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+  std::vector<std::size_t> Threads;
+  for (std::size_t Count = 1; Count < Max; Count *= 2) {
+    Threads.push_back(Count);
+  }
+  Threads.push_back(Max);
+  return Threads;
+}
+
+bool parseThreads(std::string_view Text, std::vector<std::size_t> &Threads) {
+  Threads.clear();
+  while (!Text.empty()) {
+    auto Comma = Text.find(',');
+    std::size_t Count = 0;
+    if (!parseNumber(Text.substr(0, Comma), Count) || Count == 0) {
+      return false;
+    }
+    Threads.push_back(Count);
+    Text = Comma == std::string_view::npos ? std::string_view{}
+                                           : Text.substr(Comma + 1);
+  }
+  return !Threads.empty();
+}
+
+std::optional<Options> parseOptions(int Argc, char **Argv) {
+  Options Opts{.Threads = defaultThreads()};
+  for (int I = 1; I + 1 < Argc; I += 2) {
+    std::string_view Key = Argv[I];
+    std::string_view Value = Argv[I + 1];
+    bool Ok = true;
+    if (Key == "--threads") {
+      Ok = parseThreads(Value, Opts.Threads);
+    } else if (Key == "--duration") {
+      Ok = parseNumber(Value, Opts.DurationS) && Opts.DurationS > 0;
+    } else if (Key == "--warmup") {
+      Ok = parseNumber(Value, Opts.WarmupS) && Opts.WarmupS >= 0;
+    } else if (Key == "--clients") {
+      Ok = parseNumber(Value, Opts.Clients) && Opts.Clients > 0;
+    } else if (Key == "--client-threads") {
+      Ok = parseNumber(Value, Opts.ClientThreads) && Opts.ClientThreads > 0;
+    } else if (Key == "--writes") {
+      Ok = parseNumber(Value, Opts.WriteRatio) && Opts.WriteRatio >= 0 &&
+           Opts.WriteRatio <= 1;
+    } else if (Key == "--port") {
+      Ok = parseNumber(Value, Opts.Port) && Opts.Port > 0;
+    } else if (Key == "--seed-repos") {
+      Ok = parseNumber(Value, Opts.SeedRepositories) &&
+           Opts.SeedRepositories > 0;
+    } else if (Key == "--out") {
+      Opts.OutFile = std::string(Value);
+    } else {
+      Ok = false;
+    }
+    if (!Ok) {
+      std::fprintf(stderr, "Invalid option: %s %s\n", Argv[I], Argv[I + 1]);
+      return std::nullopt;
+    }
+  }
+  if (Argc % 2 == 0) {
+    std::fprintf(stderr, "Missing value for %s\n", Argv[Argc - 1]);
+    return std::nullopt;
+  }
+  return Opts;
+}
+
+enum class Route : uint8_t {
+  List,
+  Get,
+  Accounts,
+  Stats,
+  Health,
+  Create,
+  Delete,
+};
+
+constexpr std::size_t RouteCount = 7;
+constexpr std::array<std::string_view, RouteCount> RouteNames{
+    "repos", "repo", "accounts", "stats", "health", "create", "delete"
+};
+
+// Latencies in microseconds, kept exactly, like the load generator.
+struct Samples {
+  std::vector<uint32_t> Micros;
+  uint64_t Ok{0};
+  uint64_t ClientErrors{0};
+  uint64_t ServerErrors{0};
+  uint64_t TransportErrors{0};
+
+  void record(Clock::duration Latency, int Status) {
+    if (Status == 0) {
+      ++TransportErrors;
+      return;
+    }
+    auto Us = std::chrono::duration_cast<std::chrono::microseconds>(Latency);
+    Micros.push_back(static_cast<uint32_t>(std::max<int64_t>(Us.count(), 0)));
+    if (Status >= 500) {
+      ++ServerErrors;
+    } else if (Status >= 400) {
+      ++ClientErrors;
+    } else {
+      ++Ok;
+    }
+  }
+
+  void merge(const Samples &Other) {
+    Micros.insert(Micros.end(), Other.Micros.begin(), Other.Micros.end());
+    Ok += Other.Ok;
+    ClientErrors += Other.ClientErrors;
+    ServerErrors += Other.ServerErrors;
+    TransportErrors += Other.TransportErrors;
+  }
+};
+
+struct LatencyReport {
+  double P50{0};
+  double P90{0};
+  double P99{0};
+  double P999{0};
+  double Max{0};
+  double Mean{0};
+};
+
+struct RouteReport {
+  std::string Name;
+  uint64_t Completed{0};
+  uint64_t Ok{0};
+  uint64_t ClientErrors{0};
+  uint64_t ServerErrors{0};
+  uint64_t TransportErrors{0};
+  LatencyReport LatencyMs;
+};
+
+struct LockReport {
+  std::string Name;
+  uint64_t Contended{0};
+  double WaitedMs{0};
+  // Waiting attributed to an average request, to compare across steps.
+  double WaitedPerRequestUs{0};
+};
+
+struct StepReport {
+  std::size_t Threads{0};
+  double DurationS{0};
+  double ThroughputRps{0};
+  double Speedup{0};
+  double Efficiency{0};
+  double CpuSeconds{0};
+  RouteReport Total;
+  std::vector<RouteReport> Routes;
+  std::vector<LockReport> Locks;
+};
+
+struct ChurnReport {
+  std::size_t Connections{0};
+  uint64_t Refused{0};
+  uint64_t Failed{0};
+};
+
+struct Report {
+  std::string Target;
+  std::size_t Clients{0};
+  std::size_t ClientThreads{0};
+  double WriteRatio{0};
+  std::size_t SeedRepositories{0};
+  ChurnReport Churn;
+  std::vector<StepReport> Steps;
+};
+
+LatencyReport summarize(std::vector<uint32_t> &Micros) {
+  if (Micros.empty()) {
+    return {};
+  }
+  std::ranges::sort(Micros);
+  auto At = [&](double Quantile) {
+    auto Rank = static_cast<std::size_t>(
+        std::ceil(Quantile * static_cast<double>(Micros.size()))
+    );
+    return Micros[std::clamp<std::size_t>(Rank, 1, Micros.size()) - 1] / 1e3;
+  };
+  double Sum = 0;
+  for (auto Us : Micros) {
+    Sum += Us;
+  }
+  return {
+      .P50 = At(0.50),
+      .P90 = At(0.90),
+      .P99 = At(0.99),
+      .P999 = At(0.999),
+      .Max = Micros.back() / 1e3,
+      .Mean = Sum / static_cast<double>(Micros.size()) / 1e3,
+  };
+}
+
+RouteReport routeReport(std::string Name, Samples &Data) {
+  return {
+      .Name = std::move(Name),
+      .Completed = Data.Ok + Data.ClientErrors + Data.ServerErrors +
+                   Data.TransportErrors,
+      .Ok = Data.Ok,
+      .ClientErrors = Data.ClientErrors,
+      .ServerErrors = Data.ServerErrors,
+      .TransportErrors = Data.TransportErrors,
+      .LatencyMs = summarize(Data.Micros),
+  };
+}
+
+// Entities seeded for the run, and what the clients created on top.
+struct Fixture {
+  std::string Prefix;
+  std::string AccountId;
+  std::vector<std::string> RepositoryIds;
+};
+
+struct CreatedEntity {
+  std::string Id;
+};
+
+// Shared by every client of one step.
+struct Step {
+  const Options &Opts;
+  const Fixture &Data;
+  asio::ip::tcp::resolver::results_type Endpoints;
+  Clock::time_point MeasureFrom;
+  Clock::time_point End;
+  std::atomic<uint64_t> NextName{0};
+};
+
+// A keep-alive connection with one request in flight, issuing the next as
+// soon as the previous one is answered until the step ends. Reconnects
+// after an error or a "Connection: close" from the server.
+struct Client : std::enable_shared_from_this<Client> {
+  Client(asio::io_context &Io, Step &Run, uint32_t Seed)
+      : Socket(Io), Run(Run), Rng(Seed), Results(RouteCount) {}
+
+  void start() { next(); }
+
+  const std::vector<Samples> &results() const { return Results; }
+
+  // Repository this client created and has not deleted yet, if any.
+  const std::optional<std::string> &leftover() const { return Created; }
+
+private:
+  asio::ip::tcp::socket Socket;
+  Step &Run;
+  std::mt19937 Rng;
+  std::vector<Samples> Results;
+  asio::streambuf Buffer;
+  std::string Out;
+  Route Current{Route::List};
+  Clock::time_point SentAt;
+  bool Connected{false};
+  std::optional<std::string> Created;
+  // Weights of the read routes, in Route order (List to Health).
+  std::discrete_distribution<int> ReadMix{3, 4, 1, 1, 1};
+
+  Route pick() {
+    std::uniform_real_distribution<double> Unit;
+    if (Unit(Rng) < Run.Opts.WriteRatio) {
+      return Created ? Route::Delete : Route::Create;
+    }
+    return static_cast<Route>(ReadMix(Rng));
+  }
+
+  std::string requestText(Route Kind) {
+    std::string Method = "GET";
+    std::string Path;
+    std::string Body;
+    switch (Kind) {
+    case Route::List:
+      Path = "/api/github/repos?limit=50";
+      break;
+    case Route::Get: {
+      std::uniform_int_distribution<std::size_t> Index(
+          0, Run.Data.RepositoryIds.size() - 1
+      );
+      Path = std::format(
+          "/api/github/repos/{}", Run.Data.RepositoryIds[Index(Rng)]
+      );
+      break;
+    }
+    case Route::Accounts:
+      Path = "/api/github/accounts";
+      break;
+    case Route::Stats:
+      Path = "/api/github/stats";
+      break;
+    case Route::Health:
+      Path = "/health";
+      break;
+    case Route::Create:
+      Method = "POST";
+      Path = "/api/github/repos";
+      Body = std::format(
+          R"({{"Name":"{}-w{}","AccountId":"{}","Stars":{}}})",
+          Run.Data.Prefix,
+          Run.NextName.fetch_add(1, std::memory_order_relaxed),
+          Run.Data.AccountId,
+          Rng() % 1000
+      );
+      break;
+    case Route::Delete:
+      Method = "DELETE";
+      Path = std::format("/api/github/repos/{}", *Created);
+      break;
+    }
+    auto Text = std::format(
+        "{} {} HTTP/1.1\r\nHost: 127.0.0.1:{}\r\nAccept: application/json\r\n",
+        Method,
+        Path,
+        Run.Opts.Port
+    );
+    if (!Body.empty()) {
+      Text += std::format(
+          "Content-Type: application/json\r\nContent-Length: {}\r\n",
+          Body.size()
+      );
+    }
+    Text += "\r\n";
+    Text += Body;
+    return Text;
+  }
+
+  void next() {
+    if (Clock::now() >= Run.End) {
+      std::error_code Ignored;
+      Socket.close(Ignored);
+      return;
+    }
+    Current = pick();
+    Out = requestText(Current);
+    SentAt = Clock::now();
+    if (Connected) {
+      write();
+      return;
+    }
+    asio::async_connect(
+        Socket,
+        Run.Endpoints,
+        [Self = shared_from_this()](const std::error_code &Ec, const auto &) {
+          if (Ec) {
+            Self->fail();
+            return;
+          }
+          Self->Socket.set_option(asio::ip::tcp::no_delay(true));
+          Self->Connected = true;
+          Self->write();
+        }
+    );
+  }
+
+  void write() {
+    asio::async_write(
+        Socket,
+        asio::buffer(Out),
+        [Self = shared_from_this()](const std::error_code &Ec, std::size_t) {
+          if (Ec) {
+            Self->fail();
+            return;
+          }
+          Self->readHead();
+        }
+    );
+  }
+
+  void readHead() {
+    asio::async_read_until(
+        Socket,
+        Buffer,
+        "\r\n\r\n",
+        [Self = shared_from_this()](
+            const std::error_code &Ec, std::size_t Size
+        ) {
+          if (Ec) {
+            Self->fail();
+            return;
+          }
+          Self->parseHead(Size);
+        }
+    );
+  }
+
+  void parseHead(std::size_t Size) {
+    std::string Head(
+        asio::buffers_begin(Buffer.data()),
+        asio::buffers_begin(Buffer.data()) + static_cast<std::ptrdiff_t>(Size)
+    );
+    Buffer.consume(Size);
+
+    int Status = 0;
+    std::size_t Length = 0;
+    bool HasLength = false;
+    bool KeepAlive = true;
+    std::istringstream Lines(Head);
+    std::string Line;
+    if (std::getline(Lines, Line) && Line.size() > 12) {
+      parseNumber(std::string_view(Line).substr(9, 3), Status);
+    }
+    while (std::getline(Lines, Line)) {
+      if (!Line.empty() && Line.back() == '\r') {
+        Line.pop_back();
+      }
+      auto Colon = Line.find(':');
+      if (Colon == std::string::npos) {
+        continue;
+      }
+      std::string Name = Line.substr(0, Colon);
+      std::ranges::transform(Name, Name.begin(), [](unsigned char Ch) {
+        return static_cast<char>(std::tolower(Ch));
+      });
+      auto Value = std::string_view(Line).substr(Colon + 1);
+      while (!Value.empty() && Value.front() == ' ') {
+        Value.remove_prefix(1);
+      }
+      if (Name == "content-length") {
+        HasLength = parseNumber(Value, Length);
+      } else if (Name == "connection" &&
+                 (Value == "close" || Value == "Close")) {
+        KeepAlive = false;
+      }
+    }
+    if (Status == 0 || !HasLength) {
+      fail();
+      return;
+    }
+
+    auto Buffered = Buffer.size();
+    auto Missing = Length > Buffered ? Length - Buffered : 0;
+    asio::async_read(
+        Socket,
+        Buffer,
+        asio::transfer_exactly(Missing),
+        [Self = shared_from_this(), Status, Length, KeepAlive](
+            const std::error_code &Ec, std::size_t
+        ) {
+          if (Ec) {
+            Self->fail();
+            return;
+          }
+          std::string Body(
+              asio::buffers_begin(Self->Buffer.data()),
+              asio::buffers_begin(Self->Buffer.data()) +
+                  static_cast<std::ptrdiff_t>(Length)
+          );
+          Self->Buffer.consume(Length);
+          Self->finish(Status, KeepAlive, Body);
+        }
+    );
+  }
+
+  void finish(int Status, bool KeepAlive, const std::string &Body) {
+    if (Current == Route::Create && Status == 201) {
+      CreatedEntity Entity;
+      if (!glz::read<glz::opts{.error_on_unknown_keys = false}>(
+              Entity, Body
+          )) {
+        Created = std::move(Entity.Id);
+      }
+    } else if (Current == Route::Delete && Status < 500) {
+      Created.reset();
+    }
+    if (!KeepAlive) {
+      std::error_code Ignored;
+      Socket.close(Ignored);
+      Connected = false;
+      Buffer.consume(Buffer.size());
+    }
+    record(Status);
+    next();
+  }
+
+  void fail() {
+    std::error_code Ignored;
+    Socket.close(Ignored);
+    Connected = false;
+    Buffer.consume(Buffer.size());
+    record(0);
+    next();
+  }
+
+  void record(int Status) {
+    if (SentAt >= Run.MeasureFrom && SentAt < Run.End) {
+      Results[static_cast<std::size_t>(Current)].record(
+          Clock::now() - SentAt, Status
+      );
+    }
+  }
+};
+
+std::optional<Fixture> seed(insights::server::App &App, std::size_t Count) {
+  auto &Database = *App.Database;
+  auto &State = *App.GitHubState;
+  Fixture Data{
+      .Prefix = std::format(
+          "stress-{:x}",
+          std::chrono::system_clock::now().time_since_epoch().count()
+      ),
+  };
+
+  auto Owner = Database.create(Account{.Name = Data.Prefix});
+  if (!Owner) {
+    spdlog::error("Seeding the account failed: {}", Owner.error().Message);
+    return std::nullopt;
+  }
+  insights::github::recordAccount(State, *Owner);
+  Data.AccountId = Owner->Id.str();
+
+  std::vector<Repository> Repositories;
+  Repositories.reserve(Count);
+  for (std::size_t I = 0; I < Count; ++I) {
+    Repositories.push_back({
+        .Name = std::format("{}-{}", Data.Prefix, I),
+        .AccountId = Owner->Id,
+        .Clones = static_cast<int>(I * 13 % 5000),
+        .Forks = static_cast<int>(I * 7 % 300),
+        .Stars = static_cast<int>(I * 31 % 2000),
+        .Subscribers = static_cast<int>(I % 40),
+        .Views = static_cast<int>(I * 97 % 40000),
+    });
+  }
+  auto Inserted = Database.insertMany<Repository>(Repositories);
+  if (!Inserted) {
+    spdlog::error(
+        "Seeding repositories failed: {}", Inserted.error().Message
+    );
+    return std::nullopt;
+  }
+  std::vector<Repository> Seeded;
+  Seeded.reserve(Inserted->size());
+  for (const auto &Row : *Inserted) {
+    Data.RepositoryIds.push_back(Row.Entity.Id.str());
+    Seeded.push_back(Row.Entity);
+  }
+  insights::github::recordRepositories(State, Seeded);
+  return Data;
+}
+
+void cleanup(
+    insights::server::App &App,
+    const Fixture &Data,
+    const std::vector<std::string> &Leftovers
+) {
+  auto &Database = *App.Database;
+  auto Remove = [&](const std::string &Id, auto Entity) {
+    using T = decltype(Entity);
+    if (auto Uuid = insights::core::Uuid::parse(Id)) {
+      if (auto Removed = Database.remove<T>(*Uuid); !Removed) {
+        spdlog::warn("Cleanup of {} failed: {}", Id, Removed.error().Message);
+      }
+    }
+  };
+  for (const auto &Id : Data.RepositoryIds) {
+    Remove(Id, Repository{});
+  }
+  for (const auto &Id : Leftovers) {
+    Remove(Id, Repository{});
+  }
+  Remove(Data.AccountId, Account{});
+}
+
+std::vector<LockReport> lockDelta(
+    const std::vector<insights::core::LockContention> &Before,
+    const std::vector<insights::core::LockContention> &After,
+    uint64_t Requests
+) {
+  std::vector<LockReport> Locks;
+  for (const auto &Lock : After) {
+    auto Contended = Lock.Contended;
+    auto Waited = Lock.Waited;
+    for (const auto &Earlier : Before) {
+      if (Earlier.Name == Lock.Name) {
+        Contended -= Earlier.Contended;
+        Waited -= Earlier.Waited;
+      }
+    }
+    auto WaitedUs =
+        std::chrono::duration<double, std::micro>(Waited).count();
+    Locks.push_back({
+        .Name = std::string(Lock.Name),
+        .Contended = Contended,
+        .WaitedMs = WaitedUs / 1e3,
+        .WaitedPerRequestUs =
+            Requests == 0 ? 0.0 : WaitedUs / static_cast<double>(Requests),
+    });
+  }
+  std::ranges::sort(Locks, std::greater<>{}, &LockReport::WaitedMs);
+  return Locks;
+}
+
+// Sends Count requests, each on a fresh connection that says
+// "Connection: close" and is closed after the response, one after
+// another, and counts 503s and transport failures.
+ChurnReport connectionChurn(const Options &Opts, std::size_t Count) {
+  asio::io_context Io;
+  asio::ip::tcp::resolver Resolver(Io);
+  auto Endpoints = Resolver.resolve("127.0.0.1", std::to_string(Opts.Port));
+  auto Request = std::format(
+      "GET /api/github/accounts HTTP/1.1\r\nHost: 127.0.0.1:{}\r\n"
+      "Accept: application/json\r\nConnection: close\r\n\r\n",
+      Opts.Port
+  );
+  ChurnReport Out{.Connections = Count};
+  for (std::size_t I = 0; I < Count; ++I) {
+    asio::ip::tcp::socket Socket(Io);
+    asio::streambuf Buffer;
+    std::error_code Ec;
+    asio::connect(Socket, Endpoints, Ec);
+    if (!Ec) {
+      asio::write(Socket, asio::buffer(Request), Ec);
+    }
+    if (!Ec) {
+      asio::read_until(Socket, Buffer, "\r\n", Ec);
+    }
+    int Status = 0;
+    if (!Ec && Buffer.size() > 12) {
+      std::string Line(
+          asio::buffers_begin(Buffer.data()),
+          asio::buffers_begin(Buffer.data()) + 12
+      );
+      parseNumber(std::string_view(Line).substr(9, 3), Status);
+    }
+    if (Status == 0) {
+      ++Out.Failed;
+    } else if (Status == 503) {
+      ++Out.Refused;
+    }
+    Socket.close(Ec);
+  }
+  return Out;
+}
+
+double cpuSeconds() {
+  return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+}
+
+// Runs the server on Threads threads for one warmup plus measurement
+// window and returns what the clients observed.
+StepReport runStep(
+    insights::server::App &App,
+    const Options &Opts,
+    const Fixture &Data,
+    std::size_t Threads,
+    std::vector<std::string> &Leftovers
+) {
+  std::vector<std::thread> Workers;
+  for (std::size_t I = 0; I < Threads; ++I) {
+    Workers.emplace_back([IOContext = App.IOContext] { IOContext->run(); });
+  }
+
+  asio::io_context ClientIo;
+  asio::ip::tcp::resolver Resolver(ClientIo);
+  auto Start = Clock::now();
+  auto ToDuration = [](double Seconds) {
+    return std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(Seconds)
+    );
+  };
+  Step Run{
+      .Opts = Opts,
+      .Data = Data,
+      .Endpoints =
+          Resolver.resolve("127.0.0.1", std::to_string(Opts.Port)),
+      .MeasureFrom = Start + ToDuration(Opts.WarmupS),
+      .End = Start + ToDuration(Opts.WarmupS + Opts.DurationS),
+  };
+
+  std::vector<std::shared_ptr<Client>> Clients;
+  for (std::size_t I = 0; I < Opts.Clients; ++I) {
+    Clients.push_back(std::make_shared<Client>(
+        ClientIo, Run, static_cast<uint32_t>(Threads * 1000 + I)
+    ));
+    Clients.back()->start();
+  }
+  // Requests still unanswered this long after the step are abandoned.
+  asio::steady_timer Drain(ClientIo, Run.End + std::chrono::seconds{5});
+  Drain.async_wait([&ClientIo](const std::error_code &Ec) {
+    if (!Ec) {
+      ClientIo.stop();
+    }
+  });
+
+  std::vector<std::thread> ClientThreads;
+  for (std::size_t I = 0; I < Opts.ClientThreads; ++I) {
+    ClientThreads.emplace_back([&ClientIo] { ClientIo.run(); });
+  }
+
+  std::this_thread::sleep_until(Run.MeasureFrom);
+  auto LocksBefore = insights::core::LockRegistry::snapshot();
+  auto CpuBefore = cpuSeconds();
+  std::this_thread::sleep_until(Run.End);
+  auto LocksAfter = insights::core::LockRegistry::snapshot();
+  auto CpuAfter = cpuSeconds();
+
+  // The clients stop on their own once End passes and their last request
+  // is answered; then the drain timer is the only work left.
+  while (std::ranges::any_of(Clients, [](const auto &C) {
+    return C.use_count() > 1;
+  }) && Clock::now() < Run.End + std::chrono::seconds{5}) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+  }
+  asio::post(ClientIo, [&Drain] { Drain.cancel(); });
+  for (auto &Thread : ClientThreads) {
+    Thread.join();
+  }
+
+  App.IOContext->stop();
+  for (auto &Thread : Workers) {
+    Thread.join();
+  }
+  App.IOContext->restart();
+
+  std::vector<Samples> PerRoute(RouteCount);
+  for (const auto &C : Clients) {
+    for (std::size_t I = 0; I < RouteCount; ++I) {
+      PerRoute[I].merge(C->results()[I]);
+    }
+    if (C->leftover()) {
+      Leftovers.push_back(*C->leftover());
+    }
+  }
+
+  StepReport Out{
+      .Threads = Threads,
+      .DurationS = Opts.DurationS,
+      .CpuSeconds = CpuAfter - CpuBefore,
+  };
+  Samples All;
+  for (std::size_t I = 0; I < RouteCount; ++I) {
+    All.merge(PerRoute[I]);
+    if (!PerRoute[I].Micros.empty() || PerRoute[I].TransportErrors != 0) {
+      Out.Routes.push_back(
+          routeReport(std::string(RouteNames[I]), PerRoute[I])
+      );
+    }
+  }
+  Out.Total = routeReport("total", All);
+  auto Answered =
+      Out.Total.Ok + Out.Total.ClientErrors + Out.Total.ServerErrors;
+  // Successful responses only: shed requests (503) are cheap and would
+  // flatter a saturated step.
+  Out.ThroughputRps = static_cast<double>(Out.Total.Ok) / Opts.DurationS;
+  Out.Locks = lockDelta(LocksBefore, LocksAfter, Answered);
+  return Out;
+}
+
+} // namespace
+
+int main(int Argc, char **Argv) {
+  auto Opts = parseOptions(Argc, Argv);
+  if (!Opts) {
+    return 2;
+  }
+
+  auto Config = insights::core::Config::load();
+  if (!Config) {
+    std::fprintf(stderr, "%s\n", Config.error().Message.c_str());
+    return 2;
+  }
+  Config->Host = "127.0.0.1";
+  Config->Port = Opts->Port;
+  if (std::getenv("LOG_LEVEL") == nullptr) {
+    Config->LogLevel = "warn";
+  }
+  insights::core::setupLogging(*Config);
+
+  // Every client comes from 127.0.0.1, so per-client rate limits would cap
+  // the whole run at one client's budget.
+  Config->RateLimitReadBurst = 0;
+  Config->RateLimitWriteBurst = 0;
+  Config->RateLimitExpensiveBurst = 0;
+  auto IOContext = std::make_shared<asio::io_context>();
+  auto App = insights::server::createApp(IOContext, *Config);
+  if (!App) {
+    std::fprintf(stderr, "%s\n", App.error().Message.c_str());
+    return 1;
+  }
+  if (auto Warm = insights::server::warmUp(**App, *Config); !Warm) {
+    std::fprintf(stderr, "%s\n", Warm.error().Message.c_str());
+    return 1;
+  }
+  auto Data = seed(**App, Opts->SeedRepositories);
+  if (!Data) {
+    return 1;
+  }
+  (*App)->Server.bind(Config->Host, Config->Port);
+  (*App)->Server.start(0);
+
+  Report Result{
+      .Target = std::format("{}:{}", Config->Host, Config->Port),
+      .Clients = Opts->Clients,
+      .ClientThreads = Opts->ClientThreads,
+      .WriteRatio = Opts->WriteRatio,
+      .SeedRepositories = Opts->SeedRepositories,
+  };
+  if (Config->MaxConnections != 0) {
+    std::thread Worker([IOContext] { IOContext->run(); });
+    Result.Churn = connectionChurn(*Opts, Config->MaxConnections + 1);
+    IOContext->stop();
+    Worker.join();
+    IOContext->restart();
+    std::fprintf(
+        stderr,
+        "connection churn: %zu sequential connections, %llu refused, "
+        "%llu failed\n",
+        Result.Churn.Connections,
+        static_cast<unsigned long long>(Result.Churn.Refused),
+        static_cast<unsigned long long>(Result.Churn.Failed)
+    );
+  }
+
+  std::vector<std::string> Leftovers;
+  for (auto Threads : Opts->Threads) {
+    std::fprintf(
+        stderr,
+        "%zu server threads: %gs (+%gs warmup), %zu clients\n",
+        Threads,
+        Opts->DurationS,
+        Opts->WarmupS,
+        Opts->Clients
+    );
+    auto Measured = runStep(**App, *Opts, *Data, Threads, Leftovers);
+    if (!Result.Steps.empty() && Result.Steps.front().ThroughputRps > 0) {
+      const auto &Base = Result.Steps.front();
+      Measured.Speedup = Measured.ThroughputRps / Base.ThroughputRps;
+      Measured.Efficiency = Measured.Speedup *
+                            static_cast<double>(Base.Threads) /
+                            static_cast<double>(Threads);
+    } else {
+      Measured.Speedup = 1.0;
+      Measured.Efficiency = 1.0;
+    }
+    std::fprintf(
+        stderr,
+        "  %.0f req/s (x%.2f, %.0f%% efficient), p50 %.2fms p99 %.2fms, "
+        "%llu errors, top lock: %s\n",
+        Measured.ThroughputRps,
+        Measured.Speedup,
+        Measured.Efficiency * 100,
+        Measured.Total.LatencyMs.P50,
+        Measured.Total.LatencyMs.P99,
+        static_cast<unsigned long long>(
+            Measured.Total.ServerErrors + Measured.Total.TransportErrors
+        ),
+        Measured.Locks.empty() ? "none" : Measured.Locks.front().Name.c_str()
+    );
+    Result.Steps.push_back(std::move(Measured));
+  }
+
+  (*App)->Server.stop();
+  cleanup(**App, *Data, Leftovers);
+
+  std::string Json;
+  if (auto Error = glz::write<glz::opts{.prettify = true}>(Result, Json)) {
+    std::fprintf(stderr, "Failed to write report\n");
+    return 1;
+  }
+  if (Opts->OutFile) {
+    std::ofstream(*Opts->OutFile) << Json << '\n';
+  } else {
+    std::cout << Json << '\n';
+  }
+  spdlog::shutdown();
+  return Result.Churn.Refused == 0 ? 0 : 1;
+}
@@ -0,0 +1,30 @@
+// Timestamp conversions on the row decode and response paths: every
+// decoded entity parses created_at and updated_at, and responses format
+// them back.
+#include "insights/core/timestamp.hpp"
+
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <string>
+
+namespace {
+
+void BM_ParseTimestamp(benchmark::State &State) {
+  const std::string Text = "2025-03-14 09:26:53.589793+00";
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(insights::core::parseTimestamp(Text));
+  }
+}
+BENCHMARK(BM_ParseTimestamp);
+
+void BM_FormatTimestamp(benchmark::State &State) {
+  auto Timestamp = std::chrono::system_clock::time_point{
+      std::chrono::seconds{1'742'000'000}
+  };
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(insights::core::formatTimestamp(Timestamp));
+  }
+}
+BENCHMARK(BM_FormatTimestamp);
+
+} // namespace
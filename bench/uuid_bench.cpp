@@ -0,0 +1,36 @@
+// UUID handling on the request path: uuidParam() parses every /{id}
+// parameter, and ids are rendered back to text for JSON and cache keys.
+#include "fixtures.hpp"
+#include "insights/core/uuid.hpp"
+
+#include <benchmark/benchmark.h>
+#include <string>
+
+namespace {
+
+void BM_UuidParse(benchmark::State &State) {
+  auto Text = insights::bench::syntheticUuid(42);
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(insights::core::Uuid::parse(Text));
+  }
+}
+BENCHMARK(BM_UuidParse);
+
+// Same length as a UUID, so the rejection is not just the size check.
+void BM_UuidParseInvalid(benchmark::State &State) {
+  std::string Text = "0000002a-002a-402a-8126-00000000002g";
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(insights::core::Uuid::parse(Text));
+  }
+}
+BENCHMARK(BM_UuidParseInvalid);
+
+void BM_UuidToText(benchmark::State &State) {
+  auto Id = *insights::core::Uuid::parse(insights::bench::syntheticUuid(42));
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(Id.chars());
+  }
+}
+BENCHMARK(BM_UuidToText);
+
+} // namespace
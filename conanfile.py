@@ -4,6 +4,8 @@ from conan import ConanFile
 class ICICLEInsights(ConanFile):
     settings = "os", "compiler", "build_type", "arch"
     generators = "CMakeDeps", "CMakeToolchain"
+    options = {"with_benchmarks": [True, False]}
+    default_options = {"with_benchmarks": False}
 
     def requirements(self):
         self.requires("asio/1.36.0")
@@ -12,3 +14,5 @@ class ICICLEInsights(ConanFile):
         # Use the system-installed libpq instead of building it (and its
         # transitive OpenSSL dependency) from source.
         self.requires("libpq/system", override=True)
+        if self.options.with_benchmarks:
+            self.requires("benchmark/1.9.1")
@@ -0,0 +1,219 @@
+#pragma once
+#include "glaze/net/http.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stop_token>
+#include <string_view>
+#include <thread>
+
+namespace insights::core {
+
+// Bounded multi-producer queue (Vyukov's array queue). Producers claim a
+// cell with one CAS on the enqueue cursor and never block: a full queue
+// makes tryPush fail immediately.
+template <typename T, std::size_t Capacity> struct BoundedQueue {
+  static_assert((Capacity & (Capacity - 1)) == 0, "Capacity: power of two");
+
+  BoundedQueue() : Cells(std::make_unique<Cell[]>(Capacity)) {
+    for (std::size_t I = 0; I < Capacity; ++I) {
+      Cells[I].Sequence.store(I, std::memory_order_relaxed);
+    }
+  }
+
+  bool tryPush(const T &Value) {
+    auto Pos = EnqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+      auto &Slot = Cells[Pos & (Capacity - 1)];
+      auto Sequence = Slot.Sequence.load(std::memory_order_acquire);
+      auto Diff = static_cast<std::intptr_t>(Sequence) -
+                  static_cast<std::intptr_t>(Pos);
+      if (Diff == 0) {
+        if (EnqueuePos.compare_exchange_weak(
+                Pos, Pos + 1, std::memory_order_relaxed
+            )) {
+          Slot.Data = Value;
+          Slot.Sequence.store(Pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (Diff < 0) {
+        return false;
+      } else {
+        Pos = EnqueuePos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool tryPop(T &Value) {
+    auto Pos = DequeuePos.load(std::memory_order_relaxed);
+    while (true) {
+      auto &Slot = Cells[Pos & (Capacity - 1)];
+      auto Sequence = Slot.Sequence.load(std::memory_order_acquire);
+      auto Diff = static_cast<std::intptr_t>(Sequence) -
+                  static_cast<std::intptr_t>(Pos + 1);
+      if (Diff == 0) {
+        if (DequeuePos.compare_exchange_weak(
+                Pos, Pos + 1, std::memory_order_relaxed
+            )) {
+          Value = Slot.Data;
+          Slot.Sequence.store(Pos + Capacity, std::memory_order_release);
+          return true;
+        }
+      } else if (Diff < 0) {
+        return false;
+      } else {
+        Pos = DequeuePos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+private:
+  struct Cell {
+    std::atomic<std::size_t> Sequence{0};
+    T Data{};
+  };
+
+  std::unique_ptr<Cell[]> Cells;
+  alignas(64) std::atomic<std::size_t> EnqueuePos{0};
+  alignas(64) std::atomic<std::size_t> DequeuePos{0};
+};
+
+struct AccessLogOptions {
+  // Fraction of fast 2xx/3xx requests that are logged (0..1).
+  double SampleRate{1.0};
+  // Requests at least this slow are always logged, like 4xx/5xx.
+  std::chrono::milliseconds SlowThreshold{500};
+};
+
+// Access log that keeps the request path free of sink locks and I/O.
+//
+// record() decides on sampling, copies the entry into a fixed-size slot of
+// a bounded queue and returns; a background thread formats and writes the
+// entries through the logger that was the spdlog default when the log was
+// created, which it keeps alive. When the writer falls behind and the
+// queue is full, entries are dropped and counted rather than making
+// requests wait.
+struct AccessLog {
+  explicit AccessLog(AccessLogOptions Options = {})
+      : Options(Options), Logger(spdlog::default_logger()),
+        Writer([this](std::stop_token Stop) { drain(Stop); }) {}
+
+  AccessLog(const AccessLog &) = delete;
+  AccessLog &operator=(const AccessLog &) = delete;
+
+  // Writes out everything queued so far and joins the writer; entries
+  // recorded afterwards are discarded. Call before spdlog::shutdown(), so
+  // the last requests reach the sinks while they are still open.
+  void stop() {
+    Writer.request_stop();
+    if (Writer.joinable()) {
+      Writer.join();
+    }
+  }
+
+  void record(
+      glz::http_method Method,
+      std::string_view Path,
+      int Status,
+      std::chrono::steady_clock::duration Duration
+  ) {
+    if (Status < 400 && Duration < Options.SlowThreshold && !sampled()) {
+      return;
+    }
+    Entry Item{
+        .Method = Method,
+        .Status = Status,
+        .DurationUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                          Duration
+        )
+                          .count(),
+        .PathLength = static_cast<uint8_t>(
+            std::min(Path.size(), Entry::MaxPath)
+        ),
+    };
+    std::copy_n(Path.data(), Item.PathLength, Item.Path.data());
+    if (!Queue.tryPush(Item)) {
+      Dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  uint64_t dropped() const { return Dropped.load(std::memory_order_relaxed); }
+
+private:
+  static constexpr std::size_t QueueCapacity = 8192;
+
+  struct Entry {
+    static constexpr std::size_t MaxPath = 160;
+    glz::http_method Method{};
+    int Status{0};
+    int64_t DurationUs{0};
+    uint8_t PathLength{0};
+    std::array<char, MaxPath> Path{};
+  };
+
+  bool sampled() const {
+    if (Options.SampleRate >= 1.0) {
+      return true;
+    }
+    // xorshift64: per-thread, no shared state on the request path.
+    thread_local uint64_t State =
+        0x9E3779B97F4A7C15ULL ^
+        std::hash<std::thread::id>{}(std::this_thread::get_id());
+    State ^= State << 13;
+    State ^= State >> 7;
+    State ^= State << 17;
+    return static_cast<double>(State >> 11) * 0x1.0p-53 < Options.SampleRate;
+  }
+
+  void write(const Entry &Item) const {
+    Logger->info(
+        "[{}] {} {} {}ms",
+        glz::to_string(Item.Method),
+        std::string_view{Item.Path.data(), Item.PathLength},
+        Item.Status,
+        Item.DurationUs / 1000
+    );
+  }
+
+  void drain(std::stop_token Stop) {
+    uint64_t ReportedDrops = 0;
+    Entry Item;
+    while (!Stop.stop_requested()) {
+      bool Any = false;
+      while (Queue.tryPop(Item)) {
+        write(Item);
+        Any = true;
+      }
+      if (auto Drops = dropped(); Drops != ReportedDrops) {
+        Logger->warn(
+            "Access log queue full: dropped {} entries", Drops - ReportedDrops
+        );
+        ReportedDrops = Drops;
+      }
+      if (!Any) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{5});
+      }
+    }
+    while (Queue.tryPop(Item)) {
+      write(Item);
+    }
+  }
+
+  AccessLogOptions Options;
+  std::shared_ptr<spdlog::logger> Logger;
+  BoundedQueue<Entry, QueueCapacity> Queue;
+  std::atomic<uint64_t> Dropped{0};
+  // Last member: the writer starts once everything it touches exists, and
+  // is stopped and joined before any of it is destroyed.
+  std::jthread Writer;
+};
+
+} // namespace insights::core
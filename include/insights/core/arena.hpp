@@ -0,0 +1,70 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+
+namespace insights::core {
+
+// Monotonic arena for one request's temporaries (decoded query parameters,
+// scan results, dedupe tables), installed by the arena middleware and
+// reached through requestResource().
+//
+// Allocation is a pointer bump into a per-thread block that is reused by
+// every request on that thread; a request that outgrows it takes further
+// chunks from a per-thread unsynchronized pool, so no lock is shared with
+// other server threads. Everything is released in one shot when the arena
+// goes out of scope. Nothing allocated here may outlive the request —
+// copy into a std::string before caching or storing it.
+struct RequestArena {
+  static constexpr std::size_t BlockBytes = 64 * 1024;
+
+  RequestArena() : Outer(Current) {
+    // Nested scopes (e.g. a /batch operation) share the outer arena.
+    if (Outer != nullptr) {
+      return;
+    }
+    auto &Storage = block();
+    Resource.emplace(Storage.data(), Storage.size(), &upstream());
+    Current = &*Resource;
+  }
+
+  ~RequestArena() {
+    if (Outer == nullptr) {
+      Current = nullptr;
+    }
+  }
+
+  RequestArena(const RequestArena &) = delete;
+  RequestArena &operator=(const RequestArena &) = delete;
+
+  // The active request's arena, or the default resource outside a request
+  // (startup, background tasks).
+  static std::pmr::memory_resource *resource() {
+    return Current != nullptr ? Current : std::pmr::get_default_resource();
+  }
+
+private:
+  using Block = std::array<std::byte, BlockBytes>;
+
+  static Block &block() {
+    alignas(std::max_align_t) thread_local Block Storage;
+    return Storage;
+  }
+
+  static std::pmr::memory_resource &upstream() {
+    thread_local std::pmr::unsynchronized_pool_resource Pool;
+    return Pool;
+  }
+
+  static inline thread_local std::pmr::memory_resource *Current = nullptr;
+
+  std::pmr::memory_resource *Outer;
+  std::optional<std::pmr::monotonic_buffer_resource> Resource;
+};
+
+inline std::pmr::memory_resource *requestResource() {
+  return RequestArena::resource();
+}
+
+} // namespace insights::core
@@ -0,0 +1,51 @@
+#pragma once
+#include "glaze/core/common.hpp"
+#include "glaze/net/http_router.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace insights::core {
+
+inline constexpr std::size_t MaxBatchOperations = 100;
+inline constexpr std::size_t MaxBatchBodyBytes = 1 << 20;
+
+struct BatchOperation {
+  std::string Method;
+  std::string Path;
+  std::optional<glz::raw_json> Body;
+};
+
+struct BatchRequest {
+  std::vector<BatchOperation> Operations;
+  // Skip everything after the first operation that fails (status >= 400).
+  std::optional<bool> StopOnError;
+};
+
+struct BatchResult {
+  int Status{0};
+  glz::raw_json Body{"null"};
+};
+
+struct BatchResponse {
+  std::vector<BatchResult> Results;
+};
+
+// A router as it is mounted on the server, so /batch can resolve full API
+// paths ("/api/github/repos") the same way the server does.
+struct BatchMount {
+  std::string Prefix;
+  const glz::http_router *Router{nullptr};
+};
+
+// Registers POST /batch on Router. Operations are dispatched in order
+// through the mounted routers' handlers in-process — no sockets, no
+// re-parsing of HTTP — and answered together in one JSON body. Mounts must
+// outlive the server.
+void registerBatchRoute(
+    glz::http_router &Router, std::vector<BatchMount> Mounts
+);
+
+} // namespace insights::core
@@ -0,0 +1,137 @@
+#pragma once
+#include "insights/core/contention.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace insights::core {
+
+struct ResponseCacheStats {
+  uint64_t Hits{0};
+  uint64_t Misses{0};
+  uint64_t Invalidations{0};
+  std::size_t Entries{0};
+};
+
+// Sharded in-memory cache of serialized response bodies.
+//
+// Keys are built from the route and its params (e.g. "repos/<id>") and
+// values are the exact bytes sent to the client. Entries never expire on
+// their own — every write path is responsible for invalidating the keys it
+// touches, so a hit is always as fresh as the last committed write.
+//
+// Usage:
+//   auto Ticket = Cache.ticket(Key);   // before reading from the database
+//   if (auto Body = Cache.get(Key)) { ... serve *Body ... }
+//   ...build Body from the database...
+//   Cache.put(Key, std::move(Body), Ticket);
+//
+// The ticket guards against a reader storing a body it read before a
+// concurrent writer committed and invalidated the same key.
+struct ResponseCache {
+  using Body = std::shared_ptr<const std::string>;
+
+  Body get(std::string_view Key) {
+    auto &Shard = shardFor(Key);
+    std::shared_lock Lock(Shard.Mutex);
+    auto It = Shard.Entries.find(Key);
+    if (It == Shard.Entries.end()) {
+      Misses.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    Hits.fetch_add(1, std::memory_order_relaxed);
+    return It->second;
+  }
+
+  uint64_t ticket(std::string_view Key) const {
+    return shardFor(Key).Generation.load(std::memory_order_acquire);
+  }
+
+  // Stores Value unless the key's shard was invalidated after Ticket was
+  // taken, in which case the (possibly stale) body is dropped.
+  void put(std::string Key, std::string Value, uint64_t Ticket) {
+    auto &Shard = shardFor(Key);
+    std::unique_lock Lock(Shard.Mutex);
+    if (Shard.Generation.load(std::memory_order_relaxed) != Ticket) {
+      return;
+    }
+    Shard.Entries.insert_or_assign(
+        std::move(Key), std::make_shared<const std::string>(std::move(Value))
+    );
+  }
+
+  void invalidate(std::string_view Key) {
+    auto &Shard = shardFor(Key);
+    std::unique_lock Lock(Shard.Mutex);
+    Shard.Generation.fetch_add(1, std::memory_order_release);
+    if (auto It = Shard.Entries.find(Key); It != Shard.Entries.end()) {
+      Shard.Entries.erase(It);
+    }
+    Invalidations.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void clear() {
+    for (auto &Shard : Shards) {
+      std::unique_lock Lock(Shard.Mutex);
+      Shard.Generation.fetch_add(1, std::memory_order_release);
+      Shard.Entries.clear();
+    }
+    Invalidations.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  ResponseCacheStats stats() const {
+    ResponseCacheStats Stats{
+        .Hits = Hits.load(std::memory_order_relaxed),
+        .Misses = Misses.load(std::memory_order_relaxed),
+        .Invalidations = Invalidations.load(std::memory_order_relaxed),
+    };
+    for (const auto &Shard : Shards) {
+      std::shared_lock Lock(Shard.Mutex);
+      Stats.Entries += Shard.Entries.size();
+    }
+    return Stats;
+  }
+
+private:
+  static constexpr std::size_t ShardCount = 16;
+
+  struct KeyHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view Key) const {
+      return std::hash<std::string_view>{}(Key);
+    }
+  };
+
+  struct LockTag {
+    static constexpr std::string_view Name = "response_cache";
+  };
+
+  struct Shard {
+    mutable CountedMutex<std::shared_mutex, LockTag> Mutex;
+    std::atomic<uint64_t> Generation{0};
+    std::unordered_map<std::string, Body, KeyHash, std::equal_to<>> Entries;
+  };
+
+  std::array<Shard, ShardCount> Shards;
+  std::atomic<uint64_t> Hits{0};
+  std::atomic<uint64_t> Misses{0};
+  std::atomic<uint64_t> Invalidations{0};
+
+  Shard &shardFor(std::string_view Key) {
+    return Shards[KeyHash{}(Key) % ShardCount];
+  }
+  const Shard &shardFor(std::string_view Key) const {
+    return Shards[KeyHash{}(Key) % ShardCount];
+  }
+};
+
+} // namespace insights::core
@@ -1,11 +1,14 @@
 #pragma once
 #include "insights/core/result.hpp"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <expected>
 #include <optional>
 #include <string>
+#include <string_view>
 namespace insights::core {
 
 struct Config {
@@ -15,6 +18,25 @@ struct Config {
   std::string Host{"127.0.0.1"};
   std::optional<std::string> LogDir;
   std::string LogLevel{"info"};
+  // Share of fast, successful requests written to the access log (0..1);
+  // errors and requests slower than AccessLogSlowMs are always logged.
+  double AccessLogSampleRate{1.0};
+  int AccessLogSlowMs{500};
+  // Connection lifecycle limits; 0 disables each one.
+  std::size_t MaxConnections{4096};
+  int ConnectionIdleTimeoutS{60};
+  uint32_t MaxRequestsPerConnection{1000};
+  // Per-client rate limits by route class: sustained requests per second
+  // and burst. A zero rate or burst disables that class's limit, e.g.
+  // behind a proxy where every client shares one remote address.
+  double RateLimitReadPerS{20.0};
+  uint32_t RateLimitReadBurst{120};
+  double RateLimitWritePerS{5.0};
+  uint32_t RateLimitWriteBurst{30};
+  double RateLimitExpensivePerS{0.2};
+  uint32_t RateLimitExpensiveBurst{5};
+  // Run the scheduled GitHub sync; off for load tests and PGO training.
+  bool GitHubSyncEnabled{true};
 
   static std::expected<Config, Error> load() {
     auto *DatabaseUrlEnv = std::getenv("DATABASE_URL");
@@ -23,6 +45,12 @@ struct Config {
     auto *PortEnv = std::getenv("PORT");
     auto *LogFileEnv = std::getenv("LOG_DIR");
     auto *LogLevelEnv = std::getenv("LOG_LEVEL");
+    auto *SampleRateEnv = std::getenv("ACCESS_LOG_SAMPLE_RATE");
+    auto *SlowMsEnv = std::getenv("ACCESS_LOG_SLOW_MS");
+    auto *MaxConnectionsEnv = std::getenv("MAX_CONNECTIONS");
+    auto *IdleTimeoutEnv = std::getenv("CONNECTION_IDLE_TIMEOUT_S");
+    auto *MaxRequestsEnv = std::getenv("MAX_REQUESTS_PER_CONNECTION");
+    auto *SyncEnabledEnv = std::getenv("GITHUB_SYNC_ENABLED");
 
     if (DatabaseUrlEnv == nullptr) {
       return std::unexpected(Error{"DATABASE_URL is required"});
@@ -42,7 +70,39 @@ struct Config {
       Port = std::stoi(PortEnv);
     }
 
-    return Config{
+    double AccessLogSampleRate = 1.0;
+    if (SampleRateEnv != nullptr) {
+      AccessLogSampleRate = std::clamp(std::stod(SampleRateEnv), 0.0, 1.0);
+    }
+
+    int AccessLogSlowMs = 500;
+    if (SlowMsEnv != nullptr) {
+      AccessLogSlowMs = std::stoi(SlowMsEnv);
+    }
+
+    std::size_t MaxConnections = 4096;
+    if (MaxConnectionsEnv != nullptr) {
+      MaxConnections = std::stoul(MaxConnectionsEnv);
+    }
+
+    int ConnectionIdleTimeoutS = 60;
+    if (IdleTimeoutEnv != nullptr) {
+      ConnectionIdleTimeoutS = std::max(std::stoi(IdleTimeoutEnv), 0);
+    }
+
+    uint32_t MaxRequestsPerConnection = 1000;
+    if (MaxRequestsEnv != nullptr) {
+      MaxRequestsPerConnection =
+          static_cast<uint32_t>(std::stoul(MaxRequestsEnv));
+    }
+
+    bool GitHubSyncEnabled = true;
+    if (SyncEnabledEnv != nullptr) {
+      std::string_view Value = SyncEnabledEnv;
+      GitHubSyncEnabled = Value != "0" && Value != "false";
+    }
+
+    Config Loaded{
         .Port = Port,
         .DatabaseUrl = DatabaseUrlEnv,
         .GitHubToken = GitHubTokenEnv,
@@ -50,7 +110,31 @@ struct Config {
         .LogDir = LogFileEnv != nullptr ? std::optional<std::string>{LogFileEnv}
                                         : std::nullopt,
         .LogLevel = LogLevelEnv != nullptr ? LogLevelEnv : "info",
+        .AccessLogSampleRate = AccessLogSampleRate,
+        .AccessLogSlowMs = AccessLogSlowMs,
+        .MaxConnections = MaxConnections,
+        .ConnectionIdleTimeoutS = ConnectionIdleTimeoutS,
+        .MaxRequestsPerConnection = MaxRequestsPerConnection,
+        .GitHubSyncEnabled = GitHubSyncEnabled,
+    };
+
+    auto ReadRate = [](const char *Name, double &Value) {
+      if (auto *Env = std::getenv(Name); Env != nullptr) {
+        Value = std::max(std::stod(Env), 0.0);
+      }
+    };
+    auto ReadBurst = [](const char *Name, uint32_t &Value) {
+      if (auto *Env = std::getenv(Name); Env != nullptr) {
+        Value = static_cast<uint32_t>(std::stoul(Env));
+      }
     };
+    ReadRate("RATE_LIMIT_READ_PER_S", Loaded.RateLimitReadPerS);
+    ReadBurst("RATE_LIMIT_READ_BURST", Loaded.RateLimitReadBurst);
+    ReadRate("RATE_LIMIT_WRITE_PER_S", Loaded.RateLimitWritePerS);
+    ReadBurst("RATE_LIMIT_WRITE_BURST", Loaded.RateLimitWriteBurst);
+    ReadRate("RATE_LIMIT_EXPENSIVE_PER_S", Loaded.RateLimitExpensivePerS);
+    ReadBurst("RATE_LIMIT_EXPENSIVE_BURST", Loaded.RateLimitExpensiveBurst);
+    return Loaded;
   }
 };
 
@@ -0,0 +1,130 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace insights::core {
+
+struct LockContention {
+  std::string_view Name;
+  // Acquisitions that found the lock held and had to wait.
+  uint64_t Contended{0};
+  // Total time spent in those waits.
+  std::chrono::nanoseconds Waited{0};
+};
+
+// Process-wide contention counters, one entry per lock name (all shards
+// of a sharded lock, and its shared and exclusive sides, share one entry).
+struct LockRegistry {
+  struct Counters {
+    std::string_view Name;
+    std::atomic<uint64_t> Contended{0};
+    std::atomic<int64_t> WaitedNs{0};
+  };
+
+  // The entry for Name, created on first use.
+  static Counters &add(std::string_view Name) {
+    auto &Self = instance();
+    std::scoped_lock Lock(Self.Mutex);
+    for (auto &Entry : Self.Locks) {
+      if (Entry.Name == Name) {
+        return Entry;
+      }
+    }
+    return Self.Locks.emplace_back(Name);
+  }
+
+  static std::vector<LockContention> snapshot() {
+    auto &Self = instance();
+    std::scoped_lock Lock(Self.Mutex);
+    std::vector<LockContention> Out;
+    Out.reserve(Self.Locks.size());
+    for (const auto &Entry : Self.Locks) {
+      Out.push_back({
+          .Name = Entry.Name,
+          .Contended = Entry.Contended.load(std::memory_order_relaxed),
+          .Waited = std::chrono::nanoseconds(
+              Entry.WaitedNs.load(std::memory_order_relaxed)
+          ),
+      });
+    }
+    return Out;
+  }
+
+private:
+  std::mutex Mutex;
+  // A deque keeps handed-out references valid as locks register.
+  std::deque<Counters> Locks;
+
+  static LockRegistry &instance() {
+    static LockRegistry Registry;
+    return Registry;
+  }
+};
+
+// A mutex that counts how often it was found held and how long callers
+// waited for it, under Tag::Name in the LockRegistry.
+//
+// Every acquisition is a try-lock first, so an uncontended lock costs the
+// same as the bare mutex and touches no shared counter; the clock is only
+// read on the slow path. Works with std::scoped_lock, std::unique_lock and,
+// for a std::shared_mutex, std::shared_lock.
+template <typename MutexType, typename Tag> struct CountedMutex {
+  void lock() {
+    if (!Mutex.try_lock()) {
+      waitFor([this] { Mutex.lock(); });
+    }
+  }
+
+  bool try_lock() { return Mutex.try_lock(); }
+
+  void unlock() { Mutex.unlock(); }
+
+  void lock_shared()
+    requires requires(MutexType &M) { M.lock_shared(); }
+  {
+    if (!Mutex.try_lock_shared()) {
+      waitFor([this] { Mutex.lock_shared(); });
+    }
+  }
+
+  bool try_lock_shared()
+    requires requires(MutexType &M) { M.try_lock_shared(); }
+  {
+    return Mutex.try_lock_shared();
+  }
+
+  void unlock_shared()
+    requires requires(MutexType &M) { M.unlock_shared(); }
+  {
+    Mutex.unlock_shared();
+  }
+
+private:
+  MutexType Mutex;
+
+  // One registration per lock type; waitFor is instantiated once per
+  // acquire path and must not register its own.
+  static LockRegistry::Counters &counters() {
+    static auto &Counters = LockRegistry::add(Tag::Name);
+    return Counters;
+  }
+
+  template <typename F> static void waitFor(F &&Acquire) {
+    auto &Counters = counters();
+    auto Start = std::chrono::steady_clock::now();
+    Acquire();
+    auto Waited = std::chrono::steady_clock::now() - Start;
+    Counters.Contended.fetch_add(1, std::memory_order_relaxed);
+    Counters.WaitedNs.fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Waited).count(),
+        std::memory_order_relaxed
+    );
+  }
+};
+
+} // namespace insights::core
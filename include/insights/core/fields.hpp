@@ -0,0 +1,131 @@
+#pragma once
+#include "insights/core/result.hpp"
+#include "insights/core/traits.hpp"
+
+#include "glaze/json/write.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <pqxx/pqxx>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace insights::core {
+
+// One API-visible field of a DbEntity: the name it has in the output schema,
+// the SQL column backing it, and the model member holding it. DbTraits<T>
+// lists them in a `Fields` tuple, which drives sparse fieldsets
+// (?fields=Name,Stars) both in the SQL column list and at serialization.
+template <typename T, typename M> struct Field {
+  std::string_view Name;
+  std::string_view Column;
+  M T::*Member;
+};
+
+template <typename T, typename M>
+Field(std::string_view, std::string_view, M T::*) -> Field<T, M>;
+
+// Bit I selects the I-th entry of DbTraits<T>::Fields.
+using FieldMask = uint32_t;
+
+template <typename T>
+inline constexpr std::size_t FieldCount =
+    std::tuple_size_v<std::remove_cvref_t<decltype(DbTraits<T>::Fields)>>;
+
+template <typename T, typename F> constexpr void forEachField(F &&Visit) {
+  [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+    (Visit(Is, std::get<Is>(DbTraits<T>::Fields)), ...);
+  }(std::make_index_sequence<FieldCount<T>>{});
+}
+
+// Parses a comma-separated field list against T's schema. Names are
+// case-sensitive and must match the output schema exactly; unknown or empty
+// names are rejected so typos surface as 400s instead of silently missing
+// data.
+template <typename T>
+auto parseFields(std::string_view Csv) -> std::expected<FieldMask, Error> {
+  static_assert(FieldCount<T> <= sizeof(FieldMask) * 8);
+
+  FieldMask Mask = 0;
+  while (true) {
+    auto Comma = Csv.find(',');
+    auto Name = Csv.substr(0, Comma);
+
+    bool Found = false;
+    forEachField<T>([&](std::size_t Index, const auto &Field) {
+      if (Field.Name == Name) {
+        Mask |= FieldMask{1} << Index;
+        Found = true;
+      }
+    });
+    if (!Found) {
+      return std::unexpected(Error{std::format("Unknown field '{}'", Name)});
+    }
+
+    if (Comma == std::string_view::npos) {
+      break;
+    }
+    Csv.remove_prefix(Comma + 1);
+  }
+  return Mask;
+}
+
+// "id, name" for the selected fields, in schema order.
+template <typename T> std::string columnList(FieldMask Mask) {
+  std::string Columns;
+  forEachField<T>([&](std::size_t Index, const auto &Field) {
+    if ((Mask & (FieldMask{1} << Index)) == 0) {
+      return;
+    }
+    if (!Columns.empty()) {
+      Columns.append(", ");
+    }
+    Columns.append(Field.Column);
+  });
+  return Columns;
+}
+
+// Builds an entity from a row holding only the selected columns; fields
+// outside the mask keep their default values.
+template <typename T> T fromPartialRow(const pqxx::row &Row, FieldMask Mask) {
+  T Entity{};
+  forEachField<T>([&](std::size_t Index, const auto &Field) {
+    if ((Mask & (FieldMask{1} << Index)) == 0) {
+      return;
+    }
+    using Member = std::remove_cvref_t<decltype(Entity.*(Field.Member))>;
+    Entity.*(Field.Member) = Row[Field.Column].template as<Member>();
+  });
+  return Entity;
+}
+
+// Appends {"Name":...,"Stars":...} for the selected fields of Entity.
+template <typename T>
+void appendPartialJson(const T &Entity, FieldMask Mask, std::string &Out) {
+  thread_local std::string Value;
+  Out.push_back('{');
+  bool First = true;
+  forEachField<T>([&](std::size_t Index, const auto &Field) {
+    if ((Mask & (FieldMask{1} << Index)) == 0) {
+      return;
+    }
+    if (!First) {
+      Out.push_back(',');
+    }
+    First = false;
+    Out.push_back('"');
+    Out.append(Field.Name);
+    Out.append("\":");
+    Value.clear();
+    (void)glz::write_json(Entity.*(Field.Member), Value);
+    Out.append(Value);
+  });
+  Out.push_back('}');
+}
+
+} // namespace insights::core
@@ -0,0 +1,148 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace insights::core {
+
+// 64-bit FNV-1a over the ASCII-lowercased bytes of Text, continuing from
+// Seed, with a final avalanche so linear probing sees well-spread low bits.
+// Names are case-insensitive in the API (the write routes lowercase them
+// with std::tolower), so keys hash the same regardless of case.
+inline uint64_t hashLower(
+    std::string_view Text, uint64_t Seed = 0xCBF29CE484222325ULL
+) {
+  uint64_t Hash = Seed;
+  for (unsigned char Ch : Text) {
+    if (Ch >= 'A' && Ch <= 'Z') {
+      Ch = static_cast<unsigned char>(Ch - 'A' + 'a');
+    }
+    Hash = (Hash ^ Ch) * 0x100000001B3ULL;
+  }
+  Hash ^= Hash >> 33;
+  Hash *= 0xFF51AFD7ED558CCDULL;
+  Hash ^= Hash >> 33;
+  return Hash;
+}
+
+inline bool equalsLower(std::string_view A, std::string_view B) {
+  if (A.size() != B.size()) {
+    return false;
+  }
+  auto Lower = [](unsigned char Ch) {
+    return Ch >= 'A' && Ch <= 'Z' ? Ch - 'A' + 'a' : Ch;
+  };
+  for (std::size_t I = 0; I < A.size(); ++I) {
+    if (Lower(A[I]) != Lower(B[I])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Open-addressing hash index from a precomputed 64-bit key hash to a
+// non-owning pointer, for data that is copied on every write (Snapshot).
+//
+// Slots are {hash, pointer} pairs in one power-of-two array probed
+// linearly, so copying the index is a single memcpy-like vector copy and a
+// lookup touches one or two cache lines. Keys are not stored: callers pass a
+// predicate that checks a candidate against the key they hashed. Erase uses
+// backward shifting, so there are no tombstones and probe chains stay short
+// under churn. The load factor is kept at or below 1/2.
+template <typename T> struct FlatIndex {
+  std::size_t size() const { return Count; }
+
+  void reserve(std::size_t Expected) {
+    auto Wanted = std::bit_ceil(std::max<std::size_t>(Expected * 2, 16));
+    if (Wanted > Slots.size()) {
+      rehash(Wanted);
+    }
+  }
+
+  void insert(uint64_t Hash, const T *Entity) {
+    if ((Count + 1) * 2 > Slots.size()) {
+      rehash(std::max<std::size_t>(Slots.size() * 2, 16));
+    }
+    place(Hash, Entity);
+    ++Count;
+  }
+
+  template <typename Pred>
+  const T *find(uint64_t Hash, Pred &&Matches) const {
+    if (Slots.empty()) {
+      return nullptr;
+    }
+    auto Mask = Slots.size() - 1;
+    for (auto I = Hash & Mask;; I = (I + 1) & Mask) {
+      const auto &Current = Slots[I];
+      if (Current.Entity == nullptr) {
+        return nullptr;
+      }
+      if (Current.Hash == Hash && Matches(*Current.Entity)) {
+        return Current.Entity;
+      }
+    }
+  }
+
+  // Removes the slot holding exactly Entity, if any.
+  bool erase(uint64_t Hash, const T *Entity) {
+    if (Slots.empty()) {
+      return false;
+    }
+    auto Mask = Slots.size() - 1;
+    auto I = Hash & Mask;
+    while (Slots[I].Entity != Entity) {
+      if (Slots[I].Entity == nullptr) {
+        return false;
+      }
+      I = (I + 1) & Mask;
+    }
+
+    // Backward-shift: pull later members of the probe chain into the hole
+    // unless their home slot lies cyclically after the hole.
+    for (auto J = (I + 1) & Mask; Slots[J].Entity != nullptr;
+         J = (J + 1) & Mask) {
+      auto Home = Slots[J].Hash & Mask;
+      if (((J - Home) & Mask) >= ((J - I) & Mask)) {
+        Slots[I] = Slots[J];
+        I = J;
+      }
+    }
+    Slots[I] = Slot{};
+    --Count;
+    return true;
+  }
+
+private:
+  struct Slot {
+    uint64_t Hash{0};
+    const T *Entity{nullptr};
+  };
+
+  std::vector<Slot> Slots;
+  std::size_t Count{0};
+
+  void place(uint64_t Hash, const T *Entity) {
+    auto Mask = Slots.size() - 1;
+    auto I = Hash & Mask;
+    while (Slots[I].Entity != nullptr) {
+      I = (I + 1) & Mask;
+    }
+    Slots[I] = Slot{.Hash = Hash, .Entity = Entity};
+  }
+
+  void rehash(std::size_t Capacity) {
+    auto Old = std::move(Slots);
+    Slots.assign(Capacity, Slot{});
+    for (const auto &Entry : Old) {
+      if (Entry.Entity != nullptr) {
+        place(Entry.Hash, Entry.Entity);
+      }
+    }
+  }
+};
+
+} // namespace insights::core
@@ -20,8 +20,10 @@ enum class HttpStatus : uint16_t {
   Unauthorized = 401,
   Forbidden = 403,
   NotFound = 404,
+  NotAcceptable = 406,
   Conflict = 409,
   UnprocessableEntity = 422,
+  TooManyRequests = 429,
 
   // 5xx Server Errors
   InternalServerError = 500,
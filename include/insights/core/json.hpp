@@ -0,0 +1,125 @@
+#pragma once
+#include "insights/core/http.hpp"
+#include "insights/core/negotiation.hpp"
+#include "insights/core/result.hpp"
+
+#include "glaze/beve/write.hpp"
+#include "glaze/core/common.hpp"
+#include "glaze/json/write.hpp"
+#include "glaze/net/http_router.hpp"
+
+#include <expected>
+#include <string>
+#include <string_view>
+
+namespace insights::core {
+
+struct ErrorResponse {
+  std::string_view Message;
+};
+
+// Serializes Value into a per-thread buffer that is reused across requests,
+// so steady-state responses do not grow a fresh string from zero each time.
+//
+// The returned view points into that buffer and is only valid until the
+// next writeJson/writeBody call on the same thread — copy it (into the
+// response or a cache) before serializing anything else.
+template <typename T>
+auto writeJson(const T &Value) -> std::expected<std::string_view, Error> {
+  thread_local std::string Buffer;
+  Buffer.clear();
+  if (auto JsonError = glz::write_json(Value, Buffer)) {
+    return std::unexpected(Error{glz::format_error(JsonError)});
+  }
+  return std::string_view{Buffer};
+}
+
+// Like writeJson, but in the negotiated wire format. BEVE (glaze's binary
+// format) is written from the same glz::meta / schema definitions as JSON,
+// so both formats always carry the same fields. NDJSON only applies to list
+// exports; single values fall back to JSON.
+template <typename T>
+auto writeBody(MediaType Format, const T &Value)
+    -> std::expected<std::string_view, Error> {
+  if (Format != MediaType::Beve) {
+    return writeJson(Value);
+  }
+  thread_local std::string Buffer;
+  Buffer.clear();
+  if (auto BeveError = glz::write_beve(Value, Buffer)) {
+    return std::unexpected(Error{glz::format_error(BeveError)});
+  }
+  return std::string_view{Buffer};
+}
+
+inline std::string_view contentType(MediaType Format) {
+  return Format == MediaType::Beve ? BeveMediaType : JsonMediaType;
+}
+
+inline void respondError(
+    glz::response &Response,
+    HttpStatus Status,
+    std::string_view Message,
+    MediaType Format = MediaType::Json
+) {
+  auto Body = writeBody(Format, ErrorResponse{Message});
+  if (!Body) {
+    Format = MediaType::Json;
+    Body = std::string_view{R"({"error":"Internal error"})"};
+  }
+  Response.status(static_cast<int>(Status))
+      .content_type(contentType(Format))
+      .body(*Body);
+}
+
+inline void respondError(
+    const glz::request &Request,
+    glz::response &Response,
+    HttpStatus Status,
+    std::string_view Message
+) {
+  respondError(Response, Status, Message, negotiate(Request));
+}
+
+template <typename T>
+void respondJson(glz::response &Response, HttpStatus Status, const T &Value) {
+  auto Body = writeJson(Value);
+  if (!Body) {
+    respondError(
+        Response, HttpStatus::InternalServerError, Body.error().Message
+    );
+    return;
+  }
+  Response.status(static_cast<int>(Status))
+      .content_type(JsonMediaType)
+      .body(*Body);
+}
+
+// Serializes Value in the format the client asked for via Accept (JSON
+// unless it asked for application/x-beve).
+template <typename T>
+void respond(
+    const glz::request &Request,
+    glz::response &Response,
+    HttpStatus Status,
+    const T &Value
+) {
+  auto Format = negotiate(Request);
+  auto Body = writeBody(Format, Value);
+  if (!Body) {
+    respondError(
+        Response, HttpStatus::InternalServerError, Body.error().Message, Format
+    );
+    return;
+  }
+  Response.status(static_cast<int>(Status))
+      .content_type(contentType(Format))
+      .body(*Body);
+}
+
+} // namespace insights::core
+
+template <> struct glz::meta<insights::core::ErrorResponse> {
+  using T = insights::core::ErrorResponse;
+  static constexpr auto value = glz::object("error", &T::Message);
+};
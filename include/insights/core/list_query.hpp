@@ -0,0 +1,267 @@
+#pragma once
+#include "insights/core/fields.hpp"
+#include "insights/core/query.hpp"
+#include "insights/core/result.hpp"
+#include "insights/core/uuid.hpp"
+
+#include "glaze/net/http_router.hpp"
+
+#include <charconv>
+#include <cstddef>
+#include <expected>
+#include <format>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace insights::core {
+
+enum class FilterOp {
+  Equal,
+  AtLeast,
+  AtMost,
+};
+
+struct ListFilter {
+  std::size_t FieldIndex{0};
+  FilterOp Op{FilterOp::Equal};
+  std::string Text;
+  long long Number{0};
+  // Parsed once for id columns, so the snapshot scan compares bytes.
+  Uuid Id{};
+};
+
+struct ListSort {
+  std::size_t FieldIndex{0};
+  bool Descending{false};
+};
+
+// Filtering, sorting, paging and sparse fieldsets for a list endpoint,
+// parsed from the query string:
+//
+//   ?account_id=<uuid>     equality on any column in DbTraits<T>::Fields
+//   ?min_stars=10          >= on a numeric column (max_<column> for <=)
+//   ?sort=-stars           order by a column, '-' for descending
+//   ?limit=50              at most N rows
+//   ?fields=Name,Stars     sparse fieldset (see fields.hpp)
+//
+// Column names come from the Fields whitelist, never from the request, so
+// the generated SQL only ever interpolates known identifiers; values are
+// always bound as parameters. Queries of this kind exclude soft-deleted
+// rows.
+struct ListQuery {
+  std::vector<ListFilter> Filters;
+  std::optional<ListSort> Sort;
+  std::optional<std::size_t> Limit;
+  std::optional<FieldMask> Mask;
+
+  bool empty() const {
+    return Filters.empty() && !Sort && !Limit && !Mask;
+  }
+};
+
+inline constexpr std::size_t MaxListLimit = 10000;
+
+template <typename T>
+std::optional<std::size_t> fieldIndexByColumn(std::string_view Column) {
+  std::optional<std::size_t> Found;
+  forEachField<T>([&](std::size_t Index, const auto &Field) {
+    if (Field.Column == Column) {
+      Found = Index;
+    }
+  });
+  return Found;
+}
+
+template <typename T, typename Kind>
+bool isFieldOfType(std::size_t FieldIndex) {
+  bool Matches = false;
+  forEachField<T>([&](std::size_t Index, const auto &Field) {
+    using Member = std::remove_cvref_t<
+        decltype(std::declval<const T &>().*(Field.Member))>;
+    if (Index == FieldIndex) {
+      Matches = std::is_same_v<Member, Kind>;
+    }
+  });
+  return Matches;
+}
+
+template <typename T> bool isNumericField(std::size_t FieldIndex) {
+  bool Numeric = false;
+  forEachField<T>([&](std::size_t Index, const auto &Field) {
+    using Member = std::remove_cvref_t<
+        decltype(std::declval<const T &>().*(Field.Member))>;
+    if (Index == FieldIndex) {
+      Numeric = std::is_arithmetic_v<Member>;
+    }
+  });
+  return Numeric;
+}
+
+template <typename T>
+auto parseListQuery(const glz::request &Request)
+    -> std::expected<ListQuery, Error> {
+  ListQuery Query;
+
+  auto parseNumber = [](std::string_view Name, std::string_view Value)
+      -> std::expected<long long, Error> {
+    long long Number = 0;
+    auto [End, Ec] =
+        std::from_chars(Value.data(), Value.data() + Value.size(), Number);
+    if (Ec != std::errc{} || End != Value.data() + Value.size()) {
+      return std::unexpected(
+          Error{std::format("Parameter '{}' must be an integer", Name)}
+      );
+    }
+    return Number;
+  };
+
+  for (auto &[Name, Value] : queryParams(Request)) {
+    if (Name == "fields") {
+      auto Mask = parseFields<T>(Value);
+      if (!Mask) {
+        return std::unexpected(Mask.error());
+      }
+      Query.Mask = *Mask;
+      continue;
+    }
+
+    if (Name == "limit") {
+      auto Number = parseNumber(Name, Value);
+      if (!Number) {
+        return std::unexpected(Number.error());
+      }
+      if (*Number < 1 || *Number > static_cast<long long>(MaxListLimit)) {
+        return std::unexpected(Error{
+            std::format("Parameter 'limit' must be in [1, {}]", MaxListLimit)
+        });
+      }
+      Query.Limit = static_cast<std::size_t>(*Number);
+      continue;
+    }
+
+    if (Name == "sort") {
+      std::string_view Column = Value;
+      bool Descending = Column.starts_with('-');
+      if (Descending) {
+        Column.remove_prefix(1);
+      }
+      auto Index = fieldIndexByColumn<T>(Column);
+      if (!Index) {
+        return std::unexpected(
+            Error{std::format("Cannot sort by unknown column '{}'", Column)}
+        );
+      }
+      Query.Sort = ListSort{.FieldIndex = *Index, .Descending = Descending};
+      continue;
+    }
+
+    auto Op = FilterOp::Equal;
+    std::string_view Column = Name;
+    if (Column.starts_with("min_")) {
+      Op = FilterOp::AtLeast;
+      Column.remove_prefix(4);
+    } else if (Column.starts_with("max_")) {
+      Op = FilterOp::AtMost;
+      Column.remove_prefix(4);
+    }
+
+    auto Index = fieldIndexByColumn<T>(Column);
+    if (!Index) {
+      return std::unexpected(
+          Error{std::format("Unknown query parameter '{}'", Name)}
+      );
+    }
+
+    ListFilter Filter{
+        .FieldIndex = *Index, .Op = Op, .Text = std::string(Value)
+    };
+    if (isNumericField<T>(*Index)) {
+      auto Number = parseNumber(Name, Value);
+      if (!Number) {
+        return std::unexpected(Number.error());
+      }
+      Filter.Number = *Number;
+    } else if (Op != FilterOp::Equal) {
+      return std::unexpected(Error{
+          std::format("Range filter '{}' needs a numeric column", Name)
+      });
+    } else if (isFieldOfType<T, Uuid>(*Index)) {
+      auto Id = Uuid::parse(Value);
+      if (!Id) {
+        return std::unexpected(
+            Error{std::format("Parameter '{}' must be a UUID", Name)}
+        );
+      }
+      Filter.Id = *Id;
+    }
+    Query.Filters.push_back(std::move(Filter));
+  }
+  return Query;
+}
+
+// In-memory evaluation of a ListQuery, used when serving from the snapshot.
+template <typename T> bool matches(const T &Entity, const ListQuery &Query) {
+  if (Entity.DeletedAt) {
+    return false;
+  }
+  for (const auto &Filter : Query.Filters) {
+    bool Match = true;
+    forEachField<T>([&](std::size_t Index, const auto &Field) {
+      if (Index != Filter.FieldIndex) {
+        return;
+      }
+      const auto &Value = Entity.*(Field.Member);
+      using Member = std::remove_cvref_t<decltype(Value)>;
+      if constexpr (std::is_arithmetic_v<Member>) {
+        auto Number = static_cast<long long>(Value);
+        switch (Filter.Op) {
+        case FilterOp::Equal:
+          Match = Number == Filter.Number;
+          break;
+        case FilterOp::AtLeast:
+          Match = Number >= Filter.Number;
+          break;
+        case FilterOp::AtMost:
+          Match = Number <= Filter.Number;
+          break;
+        }
+      } else if constexpr (std::is_same_v<Member, Uuid>) {
+        Match = Value == Filter.Id;
+      } else {
+        Match = Value == Filter.Text;
+      }
+    });
+    if (!Match) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Strict weak ordering by the query's sort column, ties broken by Id so
+// snapshot and SQL results come back in the same order. Text compares
+// bytewise here, so Database::list sorts text columns with COLLATE "C"
+// rather than the database's locale collation, which would order case and
+// punctuation differently.
+template <typename T>
+bool orderedBefore(const T &Lhs, const T &Rhs, const ListSort &Sort) {
+  int Order = 0;
+  forEachField<T>([&](std::size_t Index, const auto &Field) {
+    if (Index != Sort.FieldIndex) {
+      return;
+    }
+    const auto &A = Lhs.*(Field.Member);
+    const auto &B = Rhs.*(Field.Member);
+    Order = A < B ? -1 : (B < A ? 1 : 0);
+  });
+  if (Order != 0) {
+    return Sort.Descending ? Order > 0 : Order < 0;
+  }
+  return Lhs.Id < Rhs.Id;
+}
+
+} // namespace insights::core
@@ -0,0 +1,43 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace insights::core {
+
+// Collapses a warning raised on the request path into at most one line per
+// Interval. Every event is counted; the one caller per interval that claims
+// the next due time gets the count since the previous line and logs it,
+// everyone else gets 0 and skips the (synchronous) spdlog call. Exact
+// totals belong in metrics, not in this count.
+struct LogThrottle {
+  explicit LogThrottle(
+      std::chrono::nanoseconds Interval = std::chrono::seconds{10}
+  )
+      : IntervalNs(Interval.count()) {}
+
+  // Counts one event; non-zero when the caller should log a summary of
+  // that many events.
+  uint64_t record() {
+    Pending.fetch_add(1, std::memory_order_relaxed);
+    auto Now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()
+    )
+                   .count();
+    auto Due = NextDueNs.load(std::memory_order_relaxed);
+    if (Now < Due ||
+        !NextDueNs.compare_exchange_strong(
+            Due, Now + IntervalNs, std::memory_order_relaxed
+        )) {
+      return 0;
+    }
+    return Pending.exchange(0, std::memory_order_relaxed);
+  }
+
+private:
+  int64_t IntervalNs;
+  std::atomic<uint64_t> Pending{0};
+  std::atomic<int64_t> NextDueNs{0};
+};
+
+} // namespace insights::core
@@ -0,0 +1,435 @@
+#pragma once
+#include "glaze/net/http.hpp"
+#include "glaze/net/http_router.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <utility>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace insights::core {
+
+// Upper bounds (seconds) of the request latency histogram; +Inf is implied.
+inline constexpr std::array<double, 14> LatencyBuckets{
+    0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05,
+    0.1,    0.25,  0.5,    1.0,   2.5,  5.0,   10.0,
+};
+
+// Label for requests that match no registered route, so probes for unknown
+// paths share one series instead of adding one each.
+inline constexpr std::string_view UnmatchedRoute = "unmatched";
+
+// Request metrics for Prometheus.
+//
+// Requests are labelled with the template of the route they match
+// ("/api/github/repos/:id/sync"), registered through addRoutes(). Every
+// server thread records into its own shard, so observe() touches only
+// thread-private cache lines and takes no lock once a (method, route,
+// status) series exists. A shard's mutex is taken by its owner only to add
+// a series and by render() to read it; the counters themselves are relaxed
+// atomics, read while the owner keeps writing.
+struct Metrics {
+  Metrics() : Slot(NextSlot.fetch_add(1, std::memory_order_relaxed)) {}
+
+  // Adds the routes of a router mounted under Prefix to the templates
+  // request paths are labelled with. Call before the server starts; the
+  // templates are read without a lock.
+  void addRoutes(std::string_view Prefix, const glz::http_router &Router) {
+    if (Prefix.ends_with('/')) {
+      Prefix.remove_suffix(1);
+    }
+    for (const auto &[Path, Methods] : Router.routes) {
+      RouteTemplate Template{.Label = std::string(Prefix) + Path};
+      forEachSegment(Template.Label, [&](std::string_view Segment) {
+        Template.Segments.emplace_back(Segment);
+      });
+      Routes.push_back(std::move(Template));
+    }
+  }
+
+  // The template Path matches, preferring the one with the most literal
+  // segments ("/repos/by-name/:owner/:name" over "/repos/:id/:x"), or
+  // UnmatchedRoute.
+  std::string_view routeLabel(std::string_view Path) const {
+    Path = Path.substr(0, Path.find('?'));
+    thread_local std::vector<std::string_view> Segments;
+    Segments.clear();
+    forEachSegment(Path, [](std::string_view Segment) {
+      Segments.push_back(Segment);
+    });
+
+    const RouteTemplate *Best = nullptr;
+    std::size_t BestLiterals = 0;
+    for (const auto &Template : Routes) {
+      if (Template.Segments.size() != Segments.size()) {
+        continue;
+      }
+      std::size_t Literals = 0;
+      bool Matches = true;
+      for (std::size_t I = 0; I < Segments.size() && Matches; ++I) {
+        const auto &Expected = Template.Segments[I];
+        if (Expected.starts_with(':')) {
+          Matches = !Segments[I].empty();
+        } else {
+          Matches = Expected == Segments[I];
+          ++Literals;
+        }
+      }
+      if (Matches && (!Best || Literals > BestLiterals)) {
+        Best = &Template;
+        BestLiterals = Literals;
+      }
+    }
+    return Best ? std::string_view{Best->Label} : UnmatchedRoute;
+  }
+
+  void observe(
+      glz::http_method Method,
+      std::string_view Path,
+      int Status,
+      std::chrono::steady_clock::duration Duration
+  ) {
+    auto &Local = localShard();
+    auto Route = routeLabel(Path);
+    SeriesKeyView Key{
+        static_cast<uint8_t>(Method), static_cast<uint16_t>(Status), Route
+    };
+
+    auto It = Local.Series.find(Key);
+    if (It == Local.Series.end()) {
+      std::lock_guard Lock(Local.Mutex);
+      It = Local.Series
+               .try_emplace(
+                   SeriesKey{Key.Method, Key.Status, std::string(Route)}
+               )
+               .first;
+    }
+
+    auto &Entry = It->second;
+    auto Seconds = std::chrono::duration<double>(Duration).count();
+    std::size_t Bucket = 0;
+    while (Bucket < LatencyBuckets.size() &&
+           Seconds > LatencyBuckets[Bucket]) {
+      ++Bucket;
+    }
+    Entry.Buckets[Bucket].fetch_add(1, std::memory_order_relaxed);
+    Entry.SumNs.fetch_add(
+        static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Duration)
+                .count()
+        ),
+        std::memory_order_relaxed
+    );
+  }
+
+  // Adds a value read on every scrape, for counters and gauges owned by
+  // other components (Type is "counter" or "gauge").
+  void addCallback(
+      std::string Name,
+      std::string Help,
+      std::string_view Type,
+      std::function<double()> Read
+  ) {
+    std::lock_guard Lock(ShardsMutex);
+    Callbacks.push_back({
+        .Name = std::move(Name),
+        .Help = std::move(Help),
+        .Type = std::string(Type),
+        .Read = std::move(Read),
+    });
+  }
+
+  // Prometheus text exposition format (version 0.0.4).
+  std::string render() const {
+    struct Totals {
+      std::array<uint64_t, LatencyBuckets.size() + 1> Buckets{};
+      uint64_t SumNs{0};
+    };
+    std::map<std::tuple<std::string, uint8_t, uint16_t>, Totals> Merged;
+    {
+      std::lock_guard ShardsLock(ShardsMutex);
+      for (const auto &Shard : Shards) {
+        std::lock_guard Lock(Shard->Mutex);
+        for (const auto &[Key, Entry] : Shard->Series) {
+          auto &Total = Merged[{Key.Route, Key.Method, Key.Status}];
+          for (std::size_t I = 0; I < Total.Buckets.size(); ++I) {
+            Total.Buckets[I] +=
+                Entry.Buckets[I].load(std::memory_order_relaxed);
+          }
+          Total.SumNs += Entry.SumNs.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    std::string Out;
+    Out.append(
+        "# HELP insights_http_requests_total HTTP requests handled.\n"
+        "# TYPE insights_http_requests_total counter\n"
+    );
+    auto Labels = [](const auto &Key) {
+      const auto &[Route, Method, Status] = Key;
+      return std::format(
+          "method=\"{}\",route=\"{}\",status=\"{}\"",
+          glz::to_string(static_cast<glz::http_method>(Method)),
+          Route,
+          Status
+      );
+    };
+    for (const auto &[Key, Total] : Merged) {
+      uint64_t Count = 0;
+      for (auto N : Total.Buckets) {
+        Count += N;
+      }
+      std::format_to(
+          std::back_inserter(Out),
+          "insights_http_requests_total{{{}}} {}\n",
+          Labels(Key),
+          Count
+      );
+    }
+
+    Out.append(
+        "# HELP insights_http_request_duration_seconds HTTP request latency.\n"
+        "# TYPE insights_http_request_duration_seconds histogram\n"
+    );
+    for (const auto &[Key, Total] : Merged) {
+      auto KeyLabels = Labels(Key);
+      uint64_t Cumulative = 0;
+      for (std::size_t I = 0; I < Total.Buckets.size(); ++I) {
+        Cumulative += Total.Buckets[I];
+        auto Le = I < LatencyBuckets.size()
+                      ? std::format("{}", LatencyBuckets[I])
+                      : std::string{"+Inf"};
+        std::format_to(
+            std::back_inserter(Out),
+            "insights_http_request_duration_seconds_bucket{{{},le=\"{}\"}} "
+            "{}\n",
+            KeyLabels,
+            Le,
+            Cumulative
+        );
+      }
+      std::format_to(
+          std::back_inserter(Out),
+          "insights_http_request_duration_seconds_sum{{{}}} {}\n"
+          "insights_http_request_duration_seconds_count{{{}}} {}\n",
+          KeyLabels,
+          static_cast<double>(Total.SumNs) / 1e9,
+          KeyLabels,
+          Cumulative
+      );
+    }
+
+    {
+      std::lock_guard Lock(ShardsMutex);
+      for (const auto &Callback : Callbacks) {
+        std::format_to(
+            std::back_inserter(Out),
+            "# HELP {0} {1}\n# TYPE {0} {2}\n{0} {3}\n",
+            Callback.Name,
+            Callback.Help,
+            Callback.Type,
+            Callback.Read()
+        );
+      }
+    }
+
+    appendProcessMetrics(Out);
+    return Out;
+  }
+
+private:
+  struct SeriesKey {
+    uint8_t Method{0};
+    uint16_t Status{0};
+    std::string Route;
+  };
+
+  // Lets observe() look a series up without allocating its route string.
+  struct SeriesKeyView {
+    uint8_t Method{0};
+    uint16_t Status{0};
+    std::string_view Route;
+
+    SeriesKeyView(uint8_t Method, uint16_t Status, std::string_view Route)
+        : Method(Method), Status(Status), Route(Route) {}
+    SeriesKeyView(const SeriesKey &Key)
+        : Method(Key.Method), Status(Key.Status), Route(Key.Route) {}
+  };
+
+  struct SeriesKeyHash {
+    using is_transparent = void;
+    std::size_t operator()(SeriesKeyView Key) const {
+      return std::hash<std::string_view>{}(Key.Route) ^
+             (static_cast<std::size_t>(Key.Status) << 8) ^ Key.Method;
+    }
+  };
+
+  struct SeriesKeyEqual {
+    using is_transparent = void;
+    bool operator()(SeriesKeyView Lhs, SeriesKeyView Rhs) const {
+      return Lhs.Method == Rhs.Method && Lhs.Status == Rhs.Status &&
+             Lhs.Route == Rhs.Route;
+    }
+  };
+
+  struct Histogram {
+    std::array<std::atomic<uint64_t>, LatencyBuckets.size() + 1> Buckets{};
+    std::atomic<uint64_t> SumNs{0};
+  };
+
+  struct Shard {
+    mutable std::mutex Mutex;
+    std::unordered_map<SeriesKey, Histogram, SeriesKeyHash, SeriesKeyEqual>
+        Series;
+  };
+
+  struct RouteTemplate {
+    std::string Label;
+    // A segment starting with ':' matches any value.
+    std::vector<std::string> Segments;
+  };
+
+  // Calls Visit with each '/'-separated segment of Path ("/" has none).
+  template <typename Visitor>
+  static void forEachSegment(std::string_view Path, Visitor &&Visit) {
+    while (!Path.empty()) {
+      if (Path.front() == '/') {
+        Path.remove_prefix(1);
+        if (Path.empty()) {
+          break;
+        }
+      }
+      auto Slash = Path.find('/');
+      Visit(Path.substr(0, Slash));
+      Path = Slash == std::string_view::npos ? std::string_view{}
+                                             : Path.substr(Slash);
+    }
+  }
+
+  // Each instance owns a slot, never reused, in every thread's table of
+  // shards. A Metrics created at the address of a destroyed one gets a new
+  // slot, so it cannot pick up the old instance's shard.
+  //
+  // Server threads live as long as the process, so shards are never freed.
+  Shard &localShard() {
+    thread_local std::vector<Shard *> Local;
+    if (Slot >= Local.size()) {
+      Local.resize(Slot + 1, nullptr);
+    }
+    if (!Local[Slot]) {
+      std::lock_guard Lock(ShardsMutex);
+      Local[Slot] = Shards.emplace_back(std::make_unique<Shard>()).get();
+    }
+    return *Local[Slot];
+  }
+
+  // Resident memory, threads, open descriptors and CPU time from /proc.
+  static void appendProcessMetrics(std::string &Out) {
+    auto PageSize = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+    auto Ticks = static_cast<double>(::sysconf(_SC_CLK_TCK));
+
+    uint64_t SizePages = 0;
+    uint64_t ResidentPages = 0;
+    if (std::ifstream Statm("/proc/self/statm"); Statm) {
+      Statm >> SizePages >> ResidentPages;
+    }
+
+    // /proc/self/stat: fields after the parenthesized command name, so a
+    // command containing spaces cannot shift them.
+    uint64_t UserTicks = 0;
+    uint64_t SystemTicks = 0;
+    long Threads = 0;
+    if (std::ifstream Stat("/proc/self/stat"); Stat) {
+      std::string Line;
+      std::getline(Stat, Line);
+      if (auto Paren = Line.rfind(')'); Paren != std::string::npos) {
+        std::istringstream Fields(Line.substr(Paren + 2));
+        std::string Skip;
+        // state ppid pgrp session tty tpgid flags minflt cminflt majflt
+        // cmajflt, then utime stime cutime cstime priority nice threads.
+        for (int I = 0; I < 11; ++I) {
+          Fields >> Skip;
+        }
+        long ChildUser = 0;
+        long ChildSystem = 0;
+        long Priority = 0;
+        long Nice = 0;
+        Fields >> UserTicks >> SystemTicks >> ChildUser >> ChildSystem >>
+            Priority >> Nice >> Threads;
+      }
+    }
+
+    std::size_t OpenFds = 0;
+    std::error_code Ec;
+    for (auto It = std::filesystem::directory_iterator("/proc/self/fd", Ec);
+         !Ec && It != std::filesystem::directory_iterator();
+         It.increment(Ec)) {
+      ++OpenFds;
+    }
+    // Not counting the descriptor the iterator itself holds open.
+    OpenFds = OpenFds > 0 ? OpenFds - 1 : 0;
+
+    std::format_to(
+        std::back_inserter(Out),
+        "# HELP process_resident_memory_bytes Resident memory size.\n"
+        "# TYPE process_resident_memory_bytes gauge\n"
+        "process_resident_memory_bytes {}\n"
+        "# HELP process_virtual_memory_bytes Virtual memory size.\n"
+        "# TYPE process_virtual_memory_bytes gauge\n"
+        "process_virtual_memory_bytes {}\n"
+        "# HELP process_cpu_seconds_total User and system CPU time.\n"
+        "# TYPE process_cpu_seconds_total counter\n"
+        "process_cpu_seconds_total {}\n"
+        "# HELP process_threads OS threads in the process.\n"
+        "# TYPE process_threads gauge\n"
+        "process_threads {}\n"
+        "# HELP process_open_fds Open file descriptors.\n"
+        "# TYPE process_open_fds gauge\n"
+        "process_open_fds {}\n",
+        ResidentPages * PageSize,
+        SizePages * PageSize,
+        static_cast<double>(UserTicks + SystemTicks) / Ticks,
+        Threads,
+        OpenFds
+    );
+  }
+
+  struct Callback {
+    std::string Name;
+    std::string Help;
+    std::string Type;
+    std::function<double()> Read;
+  };
+
+  static inline std::atomic<std::size_t> NextSlot{0};
+
+  const std::size_t Slot;
+  std::vector<RouteTemplate> Routes;
+  mutable std::mutex ShardsMutex;
+  std::vector<std::unique_ptr<Shard>> Shards;
+  std::vector<Callback> Callbacks;
+};
+
+inline constexpr std::string_view PrometheusMediaType =
+    "text/plain; version=0.0.4";
+
+} // namespace insights::core
@@ -0,0 +1,95 @@
+#pragma once
+#include "glaze/net/http_router.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <optional>
+#include <string_view>
+
+namespace insights::core {
+
+enum class MediaType {
+  Json,
+  NdJson,
+  Beve,
+};
+
+inline constexpr std::string_view JsonMediaType = "application/json";
+inline constexpr std::string_view NdJsonMediaType = "application/x-ndjson";
+inline constexpr std::string_view BeveMediaType = "application/x-beve";
+
+inline bool equalsIgnoreCase(std::string_view Lhs, std::string_view Rhs) {
+  return std::ranges::equal(Lhs, Rhs, [](unsigned char A, unsigned char B) {
+    return std::tolower(A) == std::tolower(B);
+  });
+}
+
+// Header names are case-insensitive; don't rely on how the server stored
+// them.
+inline std::optional<std::string_view>
+findHeader(const glz::request &Request, std::string_view Name) {
+  for (const auto &[Key, Value] : Request.headers) {
+    if (equalsIgnoreCase(Key, Name)) {
+      return std::string_view{Value};
+    }
+  }
+  return std::nullopt;
+}
+
+inline std::string_view trim(std::string_view Value) {
+  while (!Value.empty() && (Value.front() == ' ' || Value.front() == '\t')) {
+    Value.remove_prefix(1);
+  }
+  while (!Value.empty() && (Value.back() == ' ' || Value.back() == '\t')) {
+    Value.remove_suffix(1);
+  }
+  return Value;
+}
+
+// Picks the response media type from the Accept header. The entry with the
+// highest q-value among the types we can produce wins; ties keep header
+// order. Anything else (missing header, */*, unsupported types) is JSON.
+inline MediaType negotiate(const glz::request &Request) {
+  auto Accept = findHeader(Request, "Accept");
+  if (!Accept) {
+    return MediaType::Json;
+  }
+
+  auto Best = MediaType::Json;
+  double BestQuality = -1.0;
+  std::string_view Remaining = *Accept;
+  while (!Remaining.empty()) {
+    auto Comma = Remaining.find(',');
+    auto Entry = Remaining.substr(0, Comma);
+    Remaining = Comma == std::string_view::npos ? std::string_view{}
+                                                : Remaining.substr(Comma + 1);
+
+    auto Semicolon = Entry.find(';');
+    auto Type = trim(Entry.substr(0, Semicolon));
+    double Quality = 1.0;
+    if (Semicolon != std::string_view::npos) {
+      auto Params = trim(Entry.substr(Semicolon + 1));
+      if (Params.starts_with("q=")) {
+        Params.remove_prefix(2);
+        std::from_chars(Params.data(), Params.data() + Params.size(), Quality);
+      }
+    }
+
+    std::optional<MediaType> Candidate;
+    if (equalsIgnoreCase(Type, JsonMediaType)) {
+      Candidate = MediaType::Json;
+    } else if (equalsIgnoreCase(Type, NdJsonMediaType)) {
+      Candidate = MediaType::NdJson;
+    } else if (equalsIgnoreCase(Type, BeveMediaType)) {
+      Candidate = MediaType::Beve;
+    }
+    if (Candidate && Quality > 0.0 && Quality > BestQuality) {
+      Best = *Candidate;
+      BestQuality = Quality;
+    }
+  }
+  return Best;
+}
+
+} // namespace insights::core
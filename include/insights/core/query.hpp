@@ -0,0 +1,126 @@
+#pragma once
+#include "insights/core/arena.hpp"
+
+#include "glaze/net/http_router.hpp"
+
+#include <cctype>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace insights::core {
+
+// Appends Encoded to Decoded with %XX escapes and '+' (space) decoded.
+template <typename String>
+void appendPercentDecoded(std::string_view Encoded, String &Decoded) {
+  auto HexValue = [](char Ch) -> int {
+    if (Ch >= '0' && Ch <= '9') {
+      return Ch - '0';
+    }
+    Ch = static_cast<char>(std::tolower(static_cast<unsigned char>(Ch)));
+    if (Ch >= 'a' && Ch <= 'f') {
+      return Ch - 'a' + 10;
+    }
+    return -1;
+  };
+
+  Decoded.reserve(Decoded.size() + Encoded.size());
+  for (std::size_t I = 0; I < Encoded.size(); ++I) {
+    if (Encoded[I] == '+') {
+      Decoded.push_back(' ');
+    } else if (Encoded[I] == '%' && I + 2 < Encoded.size() &&
+               HexValue(Encoded[I + 1]) >= 0 &&
+               HexValue(Encoded[I + 2]) >= 0) {
+      Decoded.push_back(static_cast<char>(
+          HexValue(Encoded[I + 1]) * 16 + HexValue(Encoded[I + 2])
+      ));
+      I += 2;
+    } else {
+      Decoded.push_back(Encoded[I]);
+    }
+  }
+}
+
+// Decodes %XX escapes and '+' (space) in a query-string component.
+inline std::string percentDecode(std::string_view Encoded) {
+  std::string Decoded;
+  appendPercentDecoded(Encoded, Decoded);
+  return Decoded;
+}
+
+// Returns the decoded value of the first Name=... pair in the request's
+// query string, or nullopt when the parameter is absent. A bare "Name"
+// (no '=') yields an empty string.
+inline std::optional<std::string>
+queryParam(const glz::request &Request, std::string_view Name) {
+  std::string_view Target = Request.target;
+  auto Question = Target.find('?');
+  if (Question == std::string_view::npos) {
+    return std::nullopt;
+  }
+
+  auto Query = Target.substr(Question + 1);
+  if (auto Fragment = Query.find('#'); Fragment != std::string_view::npos) {
+    Query = Query.substr(0, Fragment);
+  }
+  std::pmr::string Key(requestResource());
+  while (!Query.empty()) {
+    auto Ampersand = Query.find('&');
+    auto Pair = Query.substr(0, Ampersand);
+    Query = Ampersand == std::string_view::npos ? std::string_view{}
+                                                : Query.substr(Ampersand + 1);
+
+    auto Equals = Pair.find('=');
+    Key.clear();
+    appendPercentDecoded(Pair.substr(0, Equals), Key);
+    if (Key != Name) {
+      continue;
+    }
+    if (Equals == std::string_view::npos) {
+      return std::string{};
+    }
+    return percentDecode(Pair.substr(Equals + 1));
+  }
+  return std::nullopt;
+}
+
+using QueryParams =
+    std::pmr::vector<std::pair<std::pmr::string, std::pmr::string>>;
+
+// All Name=value pairs of the request's query string, decoded, in order.
+// Allocated from the request arena.
+inline QueryParams queryParams(const glz::request &Request) {
+  QueryParams Params(requestResource());
+  std::string_view Target = Request.target;
+  auto Question = Target.find('?');
+  if (Question == std::string_view::npos) {
+    return Params;
+  }
+
+  auto Query = Target.substr(Question + 1);
+  if (auto Fragment = Query.find('#'); Fragment != std::string_view::npos) {
+    Query = Query.substr(0, Fragment);
+  }
+  while (!Query.empty()) {
+    auto Ampersand = Query.find('&');
+    auto Pair = Query.substr(0, Ampersand);
+    Query = Ampersand == std::string_view::npos ? std::string_view{}
+                                                : Query.substr(Ampersand + 1);
+    if (Pair.empty()) {
+      continue;
+    }
+
+    auto Equals = Pair.find('=');
+    auto &[Name, Value] = Params.emplace_back();
+    appendPercentDecoded(Pair.substr(0, Equals), Name);
+    if (Equals != std::string_view::npos) {
+      appendPercentDecoded(Pair.substr(Equals + 1), Value);
+    }
+  }
+  return Params;
+}
+
+} // namespace insights::core
@@ -1,4 +1,7 @@
 #pragma once
+#include "insights/core/cache.hpp"
+#include "insights/core/metrics.hpp"
+#include "insights/core/startup.hpp"
 #include "insights/db/db.hpp"
 
 #include <glaze/net/http_router.hpp>
@@ -23,8 +26,20 @@ struct TaskStatusResponse {
   int LastAttemptAccountsFailed{0};
 };
 
+struct CacheStatsResponse {
+  uint64_t Hits{0};
+  uint64_t Misses{0};
+  uint64_t Invalidations{0};
+  std::size_t Entries{0};
+  double HitRatio{0.0};
+};
+
 void registerCoreRoutes(
-    glz::http_router &Router, std::shared_ptr<db::Database> Database
+    glz::http_router &Router,
+    std::shared_ptr<db::Database> Database,
+    std::shared_ptr<ResponseCache> Cache,
+    std::shared_ptr<Metrics> Metrics,
+    std::shared_ptr<Startup> Startup
 );
 
 } // namespace insights::core
@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace insights::core {
+
+struct StartupStep {
+  std::string Name;
+  double Ms{0.0};
+};
+
+// Body of GET /ready. Times are milliseconds since the process started.
+struct StartupReport {
+  bool Ready{false};
+  std::optional<double> ListeningMs;
+  std::optional<double> ReadyMs;
+  std::optional<double> FirstRequestMs;
+  std::vector<StartupStep> Steps;
+  std::optional<std::string> LastError;
+};
+
+// Startup timeline shared by main, the warm-up and the readiness gate: when
+// the listener came up, how long each warm-up step took, when every
+// dependency was warm and when the first request got past the gate.
+//
+// isReady() and firstRequest() are on the request path and only touch
+// atomics once the first request has been recorded.
+struct Startup {
+  using Clock = std::chrono::steady_clock;
+
+  explicit Startup(Clock::time_point Started = Clock::now())
+      : Started(Started) {}
+
+  void listening() {
+    std::scoped_lock Lock(Mutex);
+    Report.ListeningMs = sinceStart(Clock::now());
+  }
+
+  void step(std::string Name, Clock::duration Took) {
+    std::scoped_lock Lock(Mutex);
+    Report.Steps.push_back({
+        .Name = std::move(Name),
+        .Ms = std::chrono::duration<double, std::milli>(Took).count(),
+    });
+  }
+
+  void failed(std::string Error) {
+    std::scoped_lock Lock(Mutex);
+    Report.LastError = std::move(Error);
+  }
+
+  // Returns milliseconds since start.
+  double ready() {
+    std::scoped_lock Lock(Mutex);
+    Report.Ready = true;
+    Report.ReadyMs = sinceStart(Clock::now());
+    Report.LastError.reset();
+    Ready.store(true, std::memory_order_release);
+    return *Report.ReadyMs;
+  }
+
+  bool isReady() const { return Ready.load(std::memory_order_acquire); }
+
+  // Records the first request served after ready(); returns its time since
+  // start for that one call only.
+  std::optional<double> firstRequest() {
+    if (Served.load(std::memory_order_relaxed) ||
+        Served.exchange(true, std::memory_order_acq_rel)) {
+      return std::nullopt;
+    }
+    std::scoped_lock Lock(Mutex);
+    Report.FirstRequestMs = sinceStart(Clock::now());
+    return Report.FirstRequestMs;
+  }
+
+  StartupReport report() const {
+    std::scoped_lock Lock(Mutex);
+    return Report;
+  }
+
+private:
+  Clock::time_point Started;
+  std::atomic<bool> Ready{false};
+  std::atomic<bool> Served{false};
+  mutable std::mutex Mutex;
+  StartupReport Report;
+
+  double sinceStart(Clock::time_point At) const {
+    return std::chrono::duration<double, std::milli>(At - Started).count();
+  }
+};
+
+} // namespace insights::core
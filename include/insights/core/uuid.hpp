@@ -0,0 +1,209 @@
+#pragma once
+#include "insights/core/result.hpp"
+
+#include "glaze/core/common.hpp"
+#include "glaze/json/read.hpp"
+#include "glaze/json/write.hpp"
+
+#include "spdlog/fmt/fmt.h"
+
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <format>
+#include <functional>
+#include <pqxx/pqxx>
+#include <string>
+#include <string_view>
+
+namespace insights::core {
+
+// A UUID as its 16 bytes. Entity ids are stored, compared, hashed and
+// bound as this instead of their 36-character text; the text form only
+// exists at the edges (JSON, log lines, cache keys, route params).
+//
+// Ordering is bytewise, which is also how Postgres orders uuid columns and
+// how the canonical lowercase text sorts, so snapshot order and ORDER BY id
+// agree.
+struct Uuid {
+  static constexpr std::size_t TextSize = 36;
+
+  std::array<uint8_t, 16> Bytes{};
+
+  // Parses the canonical 8-4-4-4-12 hex form (either case). Every
+  // character goes through one table lookup and the validity checks are
+  // OR-ed together, so there is a single branch on the result.
+  static constexpr std::expected<Uuid, Error> parse(std::string_view Text) {
+    if (Text.size() != TextSize) {
+      return std::unexpected(Error{"UUID must be 36 characters"});
+    }
+    uint8_t Invalid = 0;
+    for (auto Dash : DashOffsets) {
+      Invalid |= Text[Dash] == '-' ? 0 : InvalidDigit;
+    }
+    Uuid Id;
+    for (std::size_t I = 0; I < Id.Bytes.size(); ++I) {
+      auto Hi = HexValues[static_cast<unsigned char>(Text[ByteOffsets[I]])];
+      auto Lo =
+          HexValues[static_cast<unsigned char>(Text[ByteOffsets[I] + 1])];
+      Invalid |= Hi | Lo;
+      Id.Bytes[I] = static_cast<uint8_t>((Hi << 4) | (Lo & 0x0F));
+    }
+    if ((Invalid & InvalidDigit) != 0) {
+      return std::unexpected(
+          Error{"UUID must be hex digits in 8-4-4-4-12 groups"}
+      );
+    }
+    return Id;
+  }
+
+  // Canonical lowercase text, without allocating.
+  constexpr std::array<char, TextSize> chars() const {
+    constexpr std::string_view Digits = "0123456789abcdef";
+    std::array<char, TextSize> Text{};
+    for (auto Dash : DashOffsets) {
+      Text[Dash] = '-';
+    }
+    for (std::size_t I = 0; I < Bytes.size(); ++I) {
+      Text[ByteOffsets[I]] = Digits[Bytes[I] >> 4];
+      Text[ByteOffsets[I] + 1] = Digits[Bytes[I] & 0x0F];
+    }
+    return Text;
+  }
+
+  std::string str() const {
+    auto Text = chars();
+    return std::string(Text.data(), Text.size());
+  }
+
+  constexpr bool isNil() const { return *this == Uuid{}; }
+
+  constexpr auto operator<=>(const Uuid &) const = default;
+  constexpr bool operator==(const Uuid &) const = default;
+
+  // glz::custom hooks: ids travel as their text in JSON and BEVE. Text that
+  // is not a UUID reads as the nil id.
+  void readText(const std::string &Text) {
+    *this = parse(Text).value_or(Uuid{});
+  }
+
+  // The view points into a per-thread buffer and is only valid until the
+  // next call on the same thread; glaze copies it out immediately.
+  std::string_view writeText() const {
+    thread_local std::array<char, TextSize> Buffer;
+    Buffer = chars();
+    return {Buffer.data(), Buffer.size()};
+  }
+
+private:
+  static constexpr uint8_t InvalidDigit = 0xF0;
+  static constexpr std::array<std::size_t, 4> DashOffsets{8, 13, 18, 23};
+
+  // Position of each byte's first hex digit in the text form.
+  static constexpr std::array<std::size_t, 16> ByteOffsets{
+      0, 2, 4, 6, 9, 11, 14, 16, 19, 21, 24, 26, 28, 30, 32, 34
+  };
+
+  // Nibble value of a hex digit; InvalidDigit marks every other character,
+  // so OR-ing lookups together leaves a high bit set if any was invalid.
+  static constexpr auto HexValues = [] {
+    std::array<uint8_t, 256> Table{};
+    Table.fill(InvalidDigit);
+    for (int Ch = '0'; Ch <= '9'; ++Ch) {
+      Table[Ch] = static_cast<uint8_t>(Ch - '0');
+    }
+    for (int Ch = 'a'; Ch <= 'f'; ++Ch) {
+      Table[Ch] = static_cast<uint8_t>(Ch - 'a' + 10);
+      Table[Ch - 'a' + 'A'] = static_cast<uint8_t>(Ch - 'a' + 10);
+    }
+    return Table;
+  }();
+};
+
+} // namespace insights::core
+
+template <> struct std::hash<insights::core::Uuid> {
+  std::size_t operator()(const insights::core::Uuid &Id) const noexcept {
+    // UUIDs are already uniformly distributed; fold the two halves.
+    uint64_t Hi = 0;
+    uint64_t Lo = 0;
+    std::memcpy(&Hi, Id.Bytes.data(), sizeof(Hi));
+    std::memcpy(&Lo, Id.Bytes.data() + sizeof(Hi), sizeof(Lo));
+    return static_cast<std::size_t>(Hi ^ (Lo * 0x9E3779B97F4A7C15ULL));
+  }
+};
+
+template <>
+struct std::formatter<insights::core::Uuid>
+    : std::formatter<std::string_view> {
+  auto format(const insights::core::Uuid &Id, std::format_context &Ctx) const {
+    auto Text = Id.chars();
+    return std::formatter<std::string_view>::format(
+        std::string_view{Text.data(), Text.size()}, Ctx
+    );
+  }
+};
+
+// spdlog formats through fmt unless it was built against std::format.
+#ifndef SPDLOG_USE_STD_FORMAT
+template <>
+struct fmt::formatter<insights::core::Uuid>
+    : fmt::formatter<fmt::string_view> {
+  auto format(const insights::core::Uuid &Id, fmt::format_context &Ctx) const {
+    auto Text = Id.chars();
+    return fmt::formatter<fmt::string_view>::format(
+        fmt::string_view{Text.data(), Text.size()}, Ctx
+    );
+  }
+};
+#endif
+
+template <> struct glz::meta<insights::core::Uuid> {
+  using T = insights::core::Uuid;
+  static constexpr auto value = glz::custom<&T::readText, &T::writeText>;
+};
+
+// Bound to and read from queries as the canonical text, which Postgres
+// casts to and from its 16-byte uuid; pqxx sends no type OIDs, so a binary
+// parameter would arrive as bytea.
+template <> struct pqxx::nullness<insights::core::Uuid>
+    : pqxx::no_null<insights::core::Uuid> {};
+
+template <> struct pqxx::string_traits<insights::core::Uuid> {
+  static constexpr bool converts_to_string{true};
+  static constexpr bool converts_from_string{true};
+
+  static insights::core::Uuid from_string(std::string_view Text) {
+    auto Id = insights::core::Uuid::parse(Text);
+    if (!Id) {
+      throw pqxx::conversion_error{
+          "Not a UUID: '" + std::string(Text) + "'"
+      };
+    }
+    return *Id;
+  }
+
+  static char *
+  into_buf(char *Begin, char *End, const insights::core::Uuid &Id) {
+    if (End - Begin < static_cast<std::ptrdiff_t>(size_buffer(Id))) {
+      throw pqxx::conversion_overrun{"Buffer too small for a UUID"};
+    }
+    auto Text = Id.chars();
+    std::memcpy(Begin, Text.data(), Text.size());
+    Begin[Text.size()] = '\0';
+    return Begin + Text.size() + 1;
+  }
+
+  static pqxx::zview
+  to_buf(char *Begin, char *End, const insights::core::Uuid &Id) {
+    auto *Terminator = into_buf(Begin, End, Id);
+    return {Begin, Terminator - Begin - 1};
+  }
+
+  static std::size_t size_buffer(const insights::core::Uuid &) noexcept {
+    return insights::core::Uuid::TextSize + 1;
+  }
+};
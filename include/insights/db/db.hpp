@@ -1,18 +1,28 @@
 #pragma once
+#include "insights/core/contention.hpp"
+#include "insights/core/fields.hpp"
+#include "insights/core/list_query.hpp"
 #include "insights/core/result.hpp"
 #include "insights/core/timestamp.hpp"
 #include "insights/core/traits.hpp"
+#include "insights/core/uuid.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <cstddef>
 #include <exception>
 #include <expected>
 #include <format>
 #include <memory>
+#include <mutex>
 #include <pqxx/pqxx>
 #include <pqxx/zview>
+#include <span>
 #include <spdlog/spdlog.h>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -32,11 +42,34 @@ struct TaskStatus {
   int LastAttemptAccountsFailed{0};
 };
 
+// One row returned by Database::insertMany.
+template <typename T> struct Upserted {
+  T Entity;
+  bool Inserted{false};
+};
+
+// Which rows a whole-table read returns: live rows only, or soft-deleted
+// ones as well.
+enum class RowFilter : uint8_t { Live, All };
+
+// One pqxx::connection, which may only run one transaction at a time:
+// every operation holds ConnectionMutex for its whole transaction, so
+// concurrent handlers queue on it (reported as "database" contention). The
+// lock is released while a retry backs off.
 struct Database {
-  pqxx::connection Cx;
+  // Selects the constructor that leaves the connection to open().
+  struct DeferConnect {};
+
+  std::unique_ptr<pqxx::connection> Cx;
 
   explicit Database(const std::string &ConnString)
-      : Cx(ConnString), ConnString(ConnString) {}
+      : Cx(std::make_unique<pqxx::connection>(ConnString)),
+        ConnString(ConnString) {}
+
+  // Not connected until open() succeeds; operations fail fast until then,
+  // so the server can register routes and listen before the database is up.
+  Database(const std::string &ConnString, DeferConnect)
+      : ConnString(ConnString) {}
 
   static std::expected<std::shared_ptr<Database>, core::Error>
   connect(const std::string &ConnString) {
@@ -51,10 +84,25 @@ struct Database {
     }
   }
 
+  // Connects a DeferConnect database; a no-op once connected.
+  std::expected<void, core::Error> open() {
+    std::scoped_lock Lock(ConnectionMutex);
+    if (Cx) {
+      return {};
+    }
+    try {
+      Cx = std::make_unique<pqxx::connection>(ConnString);
+      spdlog::info("Database::open - Connected to database");
+      return {};
+    } catch (const std::exception &Err) {
+      return std::unexpected(core::Error{Err.what()});
+    }
+  }
+
   bool reconnect() {
     spdlog::warn("Database::reconnect - Attempting to reconnect");
     try {
-      Cx = pqxx::connection(ConnString);
+      Cx = std::make_unique<pqxx::connection>(ConnString);
       spdlog::info("Database::reconnect - Reconnected successfully");
       return true;
     } catch (const std::exception &Err) {
@@ -63,8 +111,30 @@ struct Database {
     }
   }
 
+  // A trivial round trip, without retries, for health checks.
+  std::expected<void, core::Error> ping() {
+    std::scoped_lock Lock(ConnectionMutex);
+    if (!Cx) {
+      return std::unexpected(core::Error{std::string(NotConnected)});
+    }
+    try {
+      pqxx::work Tx(*Cx);
+      Tx.exec("SELECT 1");
+      return {};
+    } catch (const std::exception &Err) {
+      return std::unexpected(core::Error{Err.what()});
+    }
+  }
+
 private:
+  struct LockTag {
+    static constexpr std::string_view Name = "database";
+  };
+
+  static constexpr std::string_view NotConnected = "Database not connected";
+
   std::string ConnString;
+  core::CountedMutex<std::mutex, LockTag> ConnectionMutex;
 
   static constexpr int MaxRetries = 3;
   static constexpr std::chrono::seconds BaseDelay{1};
@@ -75,9 +145,52 @@ private:
     return std::chrono::seconds(std::min(Delay, 30LL));
   }
 
+  using ConnectionLock = std::unique_lock<decltype(ConnectionMutex)>;
+
+  // For each column of DbTraits<T>::Columns, whether it is part of the
+  // natural key (DbTraits<T>::ConflictColumns).
+  template <core::DbEntity T> static std::vector<bool> conflictColumnMask() {
+    auto Split = [](std::string_view List) {
+      std::vector<std::string_view> Names;
+      while (!List.empty()) {
+        auto Comma = List.find(',');
+        auto Name = List.substr(0, Comma);
+        while (Name.starts_with(' ')) {
+          Name.remove_prefix(1);
+        }
+        Names.push_back(Name);
+        List = Comma == std::string_view::npos ? std::string_view{}
+                                               : List.substr(Comma + 1);
+      }
+      return Names;
+    };
+    auto Keys = Split(core::DbTraits<T>::ConflictColumns);
+    std::vector<bool> Mask;
+    for (auto Column : Split(core::DbTraits<T>::Columns)) {
+      Mask.push_back(std::ranges::find(Keys, Column) != Keys.end());
+    }
+    return Mask;
+  }
+
+  // Sleeps out a backoff without holding the connection, so other handlers
+  // and the health probes are not stuck behind one failing query, then
+  // reconnects unless another caller already did.
+  void backOff(ConnectionLock &Lock, std::chrono::seconds Delay) {
+    Lock.unlock();
+    std::this_thread::sleep_for(Delay);
+    Lock.lock();
+    if (!Cx->is_open()) {
+      reconnect();
+    }
+  }
+
   template <typename F>
   auto withRetry(const char *OpName, F &&Op)
       -> std::expected<std::invoke_result_t<F>, core::Error> {
+    ConnectionLock Lock(ConnectionMutex);
+    if (!Cx) {
+      return std::unexpected(core::Error{std::string(NotConnected)});
+    }
     for (int Attempt = 0; Attempt <= MaxRetries; ++Attempt) {
       try {
         if constexpr (std::is_void_v<std::invoke_result_t<F>>) {
@@ -96,8 +209,7 @@ private:
             "{} - Connection lost (attempt {}/{}), retrying in {}s: {}",
             OpName, Attempt + 1, MaxRetries, Delay.count(), Err.what()
         );
-        std::this_thread::sleep_for(Delay);
-        reconnect();
+        backOff(Lock, Delay);
       } catch (const std::exception &Err) {
         std::string_view Msg = Err.what();
         bool IsConnectionError = 
@@ -117,8 +229,7 @@ private:
               "{} - Connection lost (attempt {}/{}), retrying in {}s: {}",
               OpName, Attempt + 1, MaxRetries, Delay.count(), Err.what()
           );
-          std::this_thread::sleep_for(Delay);
-          reconnect();
+          backOff(Lock, Delay);
           continue;
         }
 
@@ -132,9 +243,21 @@ private:
 
 public:
 
+  // Runs Op(Tx) in a read-only transaction with the usual retries, for
+  // queries that do not map onto one entity type (aggregates, reports).
+  template <typename F>
+  auto read(const char *OpName, F &&Op) -> std::expected<
+      std::invoke_result_t<F, pqxx::read_transaction &>,
+      core::Error> {
+    return withRetry(OpName, [this, &Op] {
+      pqxx::read_transaction Tx(*Cx);
+      return Op(Tx);
+    });
+  }
+
   std::expected<void, core::Error> recordTaskRun(std::string_view TaskName) {
     return withRetry("Database::recordTaskRun", [this, TaskName]() -> void {
-      pqxx::work Tx(Cx);
+      pqxx::work Tx(*Cx);
       static constexpr std::string_view Query =
           "INSERT INTO task_runs (task_name, last_run_at) VALUES ($1, NOW()) "
           "ON CONFLICT (task_name) "
@@ -147,7 +270,7 @@ public:
   std::expected<std::optional<long long>, core::Error>
   querySecondsUntilNextRun(std::string_view TaskName, std::chrono::seconds Interval) {
     return withRetry("Database::querySecondsUntilNextRun", [this, TaskName, Interval]() -> std::optional<long long> {
-      pqxx::read_transaction Tx(Cx);
+      pqxx::read_transaction Tx(*Cx);
       static constexpr std::string_view Query =
           "SELECT EXTRACT(EPOCH FROM ((last_run_at + $2::bigint * INTERVAL '1 second') - NOW()))::bigint "
           "FROM task_runs WHERE task_name = $1";
@@ -162,7 +285,7 @@ public:
   std::expected<long long, core::Error>
   recordTaskRunAttemptStart(std::string_view TaskName) {
     return withRetry("Database::recordTaskRunAttemptStart", [this, TaskName]() -> long long {
-      pqxx::work Tx(Cx);
+      pqxx::work Tx(*Cx);
       static constexpr std::string_view Query =
           "INSERT INTO task_run_attempts (task_name, status, summary) "
           "VALUES ($1, 'running', 'Task started') RETURNING id";
@@ -182,7 +305,7 @@ public:
       int AccountsFailed
   ) {
     return withRetry("Database::finishTaskRunAttempt", [=, this]() -> void {
-      pqxx::work Tx(Cx);
+      pqxx::work Tx(*Cx);
       static constexpr std::string_view Query =
           "UPDATE task_run_attempts "
           "SET finished_at = NOW(), "
@@ -212,7 +335,7 @@ public:
   std::expected<bool, core::Error>
   tryAcquireTaskLock(std::string_view TaskName) {
     return withRetry("Database::tryAcquireTaskLock", [this, TaskName]() -> bool {
-      pqxx::work Tx(Cx);
+      pqxx::work Tx(*Cx);
       static constexpr std::string_view Query =
           "SELECT pg_try_advisory_lock(hashtext($1), 0)";
       auto Res = Tx.exec(pqxx::zview{Query}, pqxx::params{TaskName});
@@ -224,7 +347,7 @@ public:
   std::expected<void, core::Error>
   releaseTaskLock(std::string_view TaskName) {
     return withRetry("Database::releaseTaskLock", [this, TaskName]() -> void {
-      pqxx::work Tx(Cx);
+      pqxx::work Tx(*Cx);
       static constexpr std::string_view Query =
           "SELECT pg_advisory_unlock(hashtext($1), 0)";
       Tx.exec(pqxx::zview{Query}, pqxx::params{TaskName});
@@ -235,7 +358,7 @@ public:
   std::expected<TaskStatus, core::Error>
   getTaskStatus(std::string_view TaskName, std::chrono::seconds Interval) {
     return withRetry("Database::getTaskStatus", [this, TaskName, Interval]() -> TaskStatus {
-      pqxx::read_transaction Tx(Cx);
+      pqxx::read_transaction Tx(*Cx);
 
       TaskStatus Status{
           .TaskName = std::string(TaskName),
@@ -294,7 +417,7 @@ public:
           "Database::create<{}> - Starting transaction",
           core::DbTraits<T>::TableName
       );
-      pqxx::work Tx(Cx);
+      pqxx::work Tx(*Cx);
       auto Params = core::DbTraits<T>::toParams(Entity);
 
       auto PlaceHolders = []<std::size_t... Is>(std::index_sequence<Is...>) {
@@ -335,15 +458,111 @@ public:
     });
   }
 
+  // Inserts Entities with one multi-row INSERT ... ON CONFLICT DO NOTHING.
+  // Rows whose natural key (DbTraits<T>::ConflictColumns) already exists
+  // are not written; they are read back in the same transaction and
+  // returned with Inserted = false, so callers get the id of every row.
+  // The key constraint covers soft-deleted rows too, so such a row may come
+  // back with DeletedAt set. Entities must not repeat a natural key.
   template <core::DbEntity T>
-  std::expected<T, core::Error> get(std::string_view Id) {
+  std::expected<std::vector<Upserted<T>>, core::Error>
+  insertMany(std::span<const T> Entities) {
+    using Rows = std::vector<Upserted<T>>;
+    return withRetry("Database::insertMany", [this, &Entities]() -> Rows {
+      if (Entities.empty()) {
+        return {};
+      }
+      pqxx::work Tx(*Cx);
+      pqxx::params Params;
+      pqxx::params KeyParams;
+      std::string Values;
+      std::string Keys;
+      auto IsKey = conflictColumnMask<T>();
+      for (const auto &Entity : Entities) {
+        Values += Values.empty() ? "(" : ", (";
+        Keys += Keys.empty() ? "(" : ", (";
+        std::apply(
+            [&](const auto &...Args) {
+              std::size_t Column = 0;
+              std::size_t KeyColumn = 0;
+              auto Append = [&](const auto &Arg) {
+                Params.append(Arg);
+                Values += std::format(
+                    "{}${}", Column == 0 ? "" : ", ", Params.size()
+                );
+                if (IsKey[Column]) {
+                  KeyParams.append(Arg);
+                  Keys += std::format(
+                      "{}${}", KeyColumn++ == 0 ? "" : ", ", KeyParams.size()
+                  );
+                }
+                ++Column;
+              };
+              (Append(Args), ...);
+            },
+            core::DbTraits<T>::toParams(Entity)
+        );
+        Values += ")";
+        Keys += ")";
+      }
+
+      auto Insert = std::format(
+          "INSERT INTO {} ({}) VALUES {} ON CONFLICT ({}) DO NOTHING "
+          "RETURNING *",
+          core::DbTraits<T>::TableName,
+          core::DbTraits<T>::Columns,
+          Values,
+          core::DbTraits<T>::ConflictColumns
+      );
+      spdlog::trace(
+          "Database::insertMany<{}> - Inserting {} rows",
+          core::DbTraits<T>::TableName,
+          Entities.size()
+      );
+      auto Inserted = Tx.exec(pqxx::zview{Insert}, Params);
+
+      Rows Results;
+      Results.reserve(Entities.size());
+      std::unordered_set<core::Uuid> InsertedIds;
+      for (const auto &Row : Inserted) {
+        auto &Result = Results.emplace_back(Upserted<T>{
+            .Entity = core::DbTraits<T>::fromRow(Row),
+            .Inserted = true,
+        });
+        InsertedIds.insert(Result.Entity.Id);
+      }
+
+      // DO NOTHING returns no row for a conflict. The conflicting rows were
+      // committed before the INSERT skipped them, so this statement sees
+      // them.
+      if (Inserted.size() < Entities.size()) {
+        auto Select = std::format(
+            "SELECT * FROM {} WHERE ({}) IN ({})",
+            core::DbTraits<T>::TableName,
+            core::DbTraits<T>::ConflictColumns,
+            Keys
+        );
+        for (const auto &Row : Tx.exec(pqxx::zview{Select}, KeyParams)) {
+          auto Entity = core::DbTraits<T>::fromRow(Row);
+          if (!InsertedIds.contains(Entity.Id)) {
+            Results.push_back({.Entity = std::move(Entity), .Inserted = false});
+          }
+        }
+      }
+      Tx.commit();
+      return Results;
+    });
+  }
+
+  template <core::DbEntity T>
+  std::expected<T, core::Error> get(const core::Uuid &Id) {
     return withRetry("Database::get", [this, Id]() -> T {
       spdlog::trace(
           "Database::get<{}> - Fetching entity with ID: {}",
           core::DbTraits<T>::TableName,
           Id
       );
-      pqxx::read_transaction Tx(Cx);
+      pqxx::read_transaction Tx(*Cx);
 
       auto Query = std::format(
           "SELECT * FROM {} WHERE id = $1", core::DbTraits<T>::TableName
@@ -369,14 +588,14 @@ public:
   }
 
   template <core::DbEntity T>
-  std::expected<T, core::Error> remove(std::string_view Id) {
+  std::expected<T, core::Error> remove(const core::Uuid &Id) {
     return withRetry("Database::remove", [this, Id]() -> T {
       spdlog::trace(
           "Database::remove<{}> - Soft deleting entity with ID: {}",
           core::DbTraits<T>::TableName,
           Id
       );
-      pqxx::work Tx(Cx);
+      pqxx::work Tx(*Cx);
 
       auto Query = std::format(
           "UPDATE {} SET deleted_at = NOW() WHERE id = $1 RETURNING *",
@@ -406,7 +625,7 @@ public:
           core::DbTraits<T>::TableName,
           Entity.Id
       );
-      pqxx::work Tx(Cx);
+      pqxx::work Tx(*Cx);
       auto Params = core::DbTraits<T>::toParams(Entity);
 
       auto Query = std::format(
@@ -433,16 +652,23 @@ public:
     });
   }
 
+  // Every live row of T, like every other list read; RowFilter::All also
+  // returns the soft-deleted ones (the snapshot keeps them so by-id reads
+  // still find them).
   template <core::DbEntity T>
-  std::expected<std::vector<T>, core::Error> getAll() {
-    return withRetry("Database::getAll", [this]() -> std::vector<T> {
+  std::expected<std::vector<T>, core::Error>
+  getAll(RowFilter Filter = RowFilter::Live) {
+    return withRetry("Database::getAll", [this, Filter]() -> std::vector<T> {
       spdlog::trace(
           "Database::getAll<{}> - Fetching all entities",
           core::DbTraits<T>::TableName
       );
-      pqxx::read_transaction Tx(Cx);
-      auto Query =
-          std::format("SELECT * FROM {}", core::DbTraits<T>::TableName);
+      pqxx::read_transaction Tx(*Cx);
+      auto Query = std::format(
+          "SELECT * FROM {}{}",
+          core::DbTraits<T>::TableName,
+          Filter == RowFilter::Live ? " WHERE deleted_at IS NULL" : ""
+      );
 
       auto Res = Tx.exec(pqxx::zview(Query));
 
@@ -459,5 +685,163 @@ public:
       return Results;
     });
   }
+
+  // Like getAll, but selects only the columns behind the fields in Mask
+  // (sparse fieldsets) and only live rows, as list() does. Fields outside
+  // the mask are left default-initialized.
+  template <core::DbEntity T>
+  std::expected<std::vector<T>, core::Error>
+  getAllFields(core::FieldMask Mask) {
+    return withRetry("Database::getAllFields", [this, Mask]() -> std::vector<T> {
+      pqxx::read_transaction Tx(*Cx);
+      auto Query = std::format(
+          "SELECT {} FROM {} WHERE deleted_at IS NULL",
+          core::columnList<T>(Mask),
+          core::DbTraits<T>::TableName
+      );
+      spdlog::trace(
+          "Database::getAllFields<{}> - Query: {}",
+          core::DbTraits<T>::TableName,
+          Query
+      );
+
+      auto Res = Tx.exec(pqxx::zview(Query));
+
+      std::vector<T> Results;
+      Results.reserve(Res.size());
+      for (const auto &Row : Res) {
+        Results.push_back(core::fromPartialRow<T>(Row, Mask));
+      }
+      return Results;
+    });
+  }
+
+  // Runs a filtered/sorted/limited list query. Column names are taken from
+  // DbTraits<T>::Fields (the request only selects them by index) and every
+  // value is bound as a parameter, so the statement stays injection-free and
+  // its shape is one of a small, plannable set. Soft-deleted rows are
+  // excluded, which lets Postgres use the partial indexes in schema.sql.
+  template <core::DbEntity T>
+  std::expected<std::vector<T>, core::Error>
+  list(const core::ListQuery &Query) {
+    return withRetry("Database::list", [this, &Query]() -> std::vector<T> {
+      pqxx::read_transaction Tx(*Cx);
+      pqxx::params Params;
+
+      auto columnOf = [](std::size_t FieldIndex) {
+        std::string_view Column;
+        core::forEachField<T>([&](std::size_t Index, const auto &Field) {
+          if (Index == FieldIndex) {
+            Column = Field.Column;
+          }
+        });
+        return Column;
+      };
+
+      std::string Sql = std::format(
+          "SELECT {} FROM {} WHERE deleted_at IS NULL",
+          Query.Mask ? core::columnList<T>(*Query.Mask) : std::string{"*"},
+          core::DbTraits<T>::TableName
+      );
+      for (const auto &Filter : Query.Filters) {
+        std::string_view Op = "=";
+        if (Filter.Op == core::FilterOp::AtLeast) {
+          Op = ">=";
+        } else if (Filter.Op == core::FilterOp::AtMost) {
+          Op = "<=";
+        }
+        if (core::isNumericField<T>(Filter.FieldIndex)) {
+          Params.append(Filter.Number);
+        } else {
+          Params.append(Filter.Text);
+        }
+        Sql += std::format(
+            " AND {} {} ${}", columnOf(Filter.FieldIndex), Op, Params.size()
+        );
+      }
+      if (Query.Sort) {
+        // Byte order, matching core::orderedBefore on the snapshot.
+        auto Text =
+            core::isFieldOfType<T, std::string>(Query.Sort->FieldIndex);
+        Sql += std::format(
+            " ORDER BY {}{} {}, id",
+            columnOf(Query.Sort->FieldIndex),
+            Text ? " COLLATE \"C\"" : "",
+            Query.Sort->Descending ? "DESC" : "ASC"
+        );
+      } else {
+        Sql += " ORDER BY id";
+      }
+      if (Query.Limit) {
+        Params.append(static_cast<long long>(*Query.Limit));
+        Sql += std::format(" LIMIT ${}", Params.size());
+      }
+      spdlog::trace(
+          "Database::list<{}> - Query: {}", core::DbTraits<T>::TableName, Sql
+      );
+
+      auto Res = Tx.exec(pqxx::zview(Sql), Params);
+
+      std::vector<T> Results;
+      Results.reserve(Res.size());
+      for (const auto &Row : Res) {
+        Results.push_back(
+            Query.Mask ? core::fromPartialRow<T>(Row, *Query.Mask)
+                       : core::DbTraits<T>::fromRow(Row)
+        );
+      }
+      return Results;
+    });
+  }
+
+  // Streams every live row of T through Callback, fetching BatchSize rows
+  // at a time from a server-side cursor so the full result set is never
+  // held in memory. Returns the number of rows visited.
+  //
+  // Not wrapped in withRetry: rows already handed to Callback cannot be
+  // taken back, so a retry after a dropped connection would emit them twice.
+  template <core::DbEntity T, typename F>
+  std::expected<std::size_t, core::Error>
+  forEach(F &&Callback, std::size_t BatchSize = 500) {
+    std::scoped_lock Lock(ConnectionMutex);
+    if (!Cx) {
+      return std::unexpected(core::Error{std::string(NotConnected)});
+    }
+    try {
+      spdlog::trace(
+          "Database::forEach<{}> - Opening cursor", core::DbTraits<T>::TableName
+      );
+      pqxx::read_transaction Tx(*Cx);
+      auto Query = std::format(
+          "SELECT * FROM {} WHERE deleted_at IS NULL",
+          core::DbTraits<T>::TableName
+      );
+      pqxx::icursorstream Cursor(
+          Tx,
+          Query,
+          std::format("{}_stream", core::DbTraits<T>::TableName),
+          static_cast<pqxx::icursorstream::difference_type>(BatchSize)
+      );
+
+      std::size_t Count = 0;
+      pqxx::result Batch;
+      while (Cursor >> Batch) {
+        for (const auto &Row : Batch) {
+          Callback(core::DbTraits<T>::fromRow(Row));
+          ++Count;
+        }
+      }
+
+      spdlog::trace(
+          "Database::forEach<{}> - Streamed {} entities",
+          core::DbTraits<T>::TableName,
+          Count
+      );
+      return Count;
+    } catch (const std::exception &Err) {
+      spdlog::error("Database::forEach - Failed: {}", Err.what());
+      return std::unexpected(core::Error{Err.what()});
+    }
+  }
 };
 } // namespace insights::db
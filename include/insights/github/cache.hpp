@@ -0,0 +1,52 @@
+#pragma once
+#include "insights/core/cache.hpp"
+#include "insights/core/negotiation.hpp"
+#include "insights/core/uuid.hpp"
+
+#include <format>
+#include <string>
+#include <string_view>
+
+namespace insights::github::cache {
+
+// Response cache keys for the github routes. Lists and single entities are
+// cached separately; any write to an entity also drops the list it belongs
+// to. Each key is cached once per wire format (see variantKey).
+inline constexpr std::string_view AccountsKey = "accounts";
+inline constexpr std::string_view RepositoriesKey = "repos";
+
+inline std::string accountKey(const core::Uuid &Id) {
+  return std::format("{}/{}", AccountsKey, Id);
+}
+
+inline std::string repositoryKey(const core::Uuid &Id) {
+  return std::format("{}/{}", RepositoriesKey, Id);
+}
+
+// JSON bodies live under the plain key; other formats get a suffix.
+inline std::string variantKey(std::string_view Key, core::MediaType Format) {
+  if (Format == core::MediaType::Beve) {
+    return std::format("{}#beve", Key);
+  }
+  return std::string(Key);
+}
+
+inline void
+invalidateAllFormats(core::ResponseCache &Cache, std::string_view Key) {
+  Cache.invalidate(variantKey(Key, core::MediaType::Json));
+  Cache.invalidate(variantKey(Key, core::MediaType::Beve));
+}
+
+inline void
+invalidateAccount(core::ResponseCache &Cache, const core::Uuid &Id) {
+  invalidateAllFormats(Cache, accountKey(Id));
+  invalidateAllFormats(Cache, AccountsKey);
+}
+
+inline void
+invalidateRepository(core::ResponseCache &Cache, const core::Uuid &Id) {
+  invalidateAllFormats(Cache, repositoryKey(Id));
+  invalidateAllFormats(Cache, RepositoriesKey);
+}
+
+} // namespace insights::github::cache
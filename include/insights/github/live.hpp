@@ -0,0 +1,386 @@
+#pragma once
+#include "insights/core/contention.hpp"
+#include "insights/core/uuid.hpp"
+#include "insights/github/models.hpp"
+#include "insights/github/snapshot.hpp"
+
+#include "glaze/json/write.hpp"
+
+#include <algorithm>
+#include <array>
+#include <asio/steady_timer.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <shared_mutex>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace insights::github {
+
+enum class LiveTopic : uint8_t { Accounts, Repositories, Leaderboard };
+
+inline constexpr std::size_t LiveTopicCount = 3;
+
+// Topic names match the route segments the entities are served under.
+inline constexpr std::array<std::string_view, LiveTopicCount> LiveTopicNames{
+    "accounts", "repos", "leaderboard"
+};
+
+inline std::optional<LiveTopic> parseLiveTopic(std::string_view Name) {
+  for (std::size_t I = 0; I < LiveTopicNames.size(); ++I) {
+    if (LiveTopicNames[I] == Name) {
+      return static_cast<LiveTopic>(I);
+    }
+  }
+  return std::nullopt;
+}
+
+// Client -> server: {"Subscribe":["repos"],"Unsubscribe":["accounts"]}.
+struct LiveCommand {
+  std::vector<std::string> Subscribe;
+  std::vector<std::string> Unsubscribe;
+};
+
+// Server -> client for accounts/repos: every entity committed since the
+// previous frame, coalesced by Id (only the latest version is sent).
+// Soft-deleted entities are listed by Id only.
+template <typename T> struct LiveDelta {
+  std::string_view Topic;
+  uint64_t Seq{0};
+  std::vector<std::shared_ptr<const T>> Upserted;
+  std::vector<core::Uuid> Deleted;
+};
+
+struct LeaderboardEntry {
+  core::Uuid Id;
+  std::string Name;
+  core::Uuid AccountId;
+  int Stars{0};
+
+  bool operator==(const LeaderboardEntry &) const = default;
+};
+
+// Server -> client for leaderboard: the full top repositories by stars,
+// sent on subscribe and whenever the ranking changes.
+struct LeaderboardFrame {
+  std::string_view Topic;
+  uint64_t Seq{0};
+  std::vector<LeaderboardEntry> Top;
+};
+
+struct LiveStats {
+  std::size_t Subscribers{0};
+  uint64_t Frames{0};
+  uint64_t Sends{0};
+};
+
+// Fans committed entity changes out to WebSocket subscribers.
+//
+// The write path (recordAccount/recordRepository) only drops the new
+// version into a pending map keyed by Id, and returns straight away when
+// nobody listens to the topic. startLiveFlush drains that map on a timer:
+// each topic is serialized once per tick and the same buffer is handed to
+// every subscriber, so a burst of writes (a sync commits thousands of
+// rows) costs one frame per topic per tick rather than one per write per
+// client, and a slow client never holds up a writer.
+//
+// Subscribers are opaque to the hub: a key (the connection's address) and
+// a Sender that queues a frame on the connection, returning false once the
+// connection is gone so the hub can prune it.
+struct LiveHub {
+  using Frame = std::shared_ptr<const std::string>;
+  using Sender = std::function<bool(const Frame &)>;
+
+  static constexpr std::size_t LeaderboardSize = 10;
+
+  explicit LiveHub(std::shared_ptr<SnapshotStore> Snapshot)
+      : Snapshot(std::move(Snapshot)) {}
+
+  void connect(const void *Key, Sender Send) {
+    std::unique_lock Lock(SubscribersMutex);
+    Subscribers.try_emplace(Key, Subscriber{.Send = std::move(Send)});
+  }
+
+  void disconnect(const void *Key) {
+    std::unique_lock Lock(SubscribersMutex);
+    if (auto It = Subscribers.find(Key); It != Subscribers.end()) {
+      release(It->second.Topics);
+      Subscribers.erase(It);
+    }
+  }
+
+  void subscribe(const void *Key, LiveTopic Topic) {
+    Sender Send;
+    {
+      std::unique_lock Lock(SubscribersMutex);
+      auto It = Subscribers.find(Key);
+      auto Bit = topicBit(Topic);
+      if (It == Subscribers.end() || (It->second.Topics & Bit) != 0) {
+        return;
+      }
+      It->second.Topics |= Bit;
+      Listeners[index(Topic)].fetch_add(1, std::memory_order_relaxed);
+      Send = It->second.Send;
+    }
+    // A leaderboard is a full state, so a new subscriber gets it at once
+    // instead of waiting for the next change.
+    if (Topic == LiveTopic::Leaderboard) {
+      if (auto Frame = leaderboardFrame(leaderboard())) {
+        Send(Frame);
+      }
+    }
+  }
+
+  void unsubscribe(const void *Key, LiveTopic Topic) {
+    std::unique_lock Lock(SubscribersMutex);
+    auto It = Subscribers.find(Key);
+    auto Bit = topicBit(Topic);
+    if (It == Subscribers.end() || (It->second.Topics & Bit) == 0) {
+      return;
+    }
+    It->second.Topics &= ~Bit;
+    release(Bit);
+  }
+
+  void publish(const models::Account &Account) {
+    if (!listening(LiveTopic::Accounts)) {
+      return;
+    }
+    auto Entity = std::make_shared<const models::Account>(Account);
+    std::scoped_lock Lock(PendingMutex);
+    PendingAccounts.insert_or_assign(Account.Id, std::move(Entity));
+  }
+
+  void publish(const models::Repository &Repository) {
+    if (!listening(LiveTopic::Repositories) &&
+        !listening(LiveTopic::Leaderboard)) {
+      return;
+    }
+    auto Entity = std::make_shared<const models::Repository>(Repository);
+    std::scoped_lock Lock(PendingMutex);
+    PendingRepositories.insert_or_assign(Repository.Id, std::move(Entity));
+  }
+
+  // Sends everything published since the last flush. Called from the flush
+  // timer only, so LastLeaderboard needs no lock.
+  void flush() {
+    decltype(PendingAccounts) Accounts;
+    decltype(PendingRepositories) Repositories;
+    {
+      std::scoped_lock Lock(PendingMutex);
+      Accounts.swap(PendingAccounts);
+      Repositories.swap(PendingRepositories);
+    }
+
+    if (!Accounts.empty() && listening(LiveTopic::Accounts)) {
+      broadcast(
+          LiveTopic::Accounts, deltaFrame(LiveTopic::Accounts, Accounts)
+      );
+    }
+    if (Repositories.empty()) {
+      return;
+    }
+    if (listening(LiveTopic::Repositories)) {
+      broadcast(
+          LiveTopic::Repositories,
+          deltaFrame(LiveTopic::Repositories, Repositories)
+      );
+    }
+    if (listening(LiveTopic::Leaderboard)) {
+      auto Top = leaderboard();
+      if (Top != LastLeaderboard) {
+        broadcast(LiveTopic::Leaderboard, leaderboardFrame(Top));
+        LastLeaderboard = std::move(Top);
+      }
+    }
+  }
+
+  LiveStats stats() const {
+    std::shared_lock Lock(SubscribersMutex);
+    return {
+        .Subscribers = Subscribers.size(),
+        .Frames = Frames.load(std::memory_order_relaxed),
+        .Sends = Sends.load(std::memory_order_relaxed),
+    };
+  }
+
+private:
+  struct Subscriber {
+    Sender Send;
+    uint8_t Topics{0};
+  };
+
+  std::shared_ptr<SnapshotStore> Snapshot;
+
+  mutable std::shared_mutex SubscribersMutex;
+  std::unordered_map<const void *, Subscriber> Subscribers;
+  std::array<std::atomic<std::size_t>, LiveTopicCount> Listeners{};
+
+  struct PendingLockTag {
+    static constexpr std::string_view Name = "live_pending";
+  };
+
+  core::CountedMutex<std::mutex, PendingLockTag> PendingMutex;
+  std::unordered_map<core::Uuid, std::shared_ptr<const models::Account>>
+      PendingAccounts;
+  std::unordered_map<core::Uuid, std::shared_ptr<const models::Repository>>
+      PendingRepositories;
+
+  std::vector<LeaderboardEntry> LastLeaderboard;
+  std::atomic<uint64_t> Seq{0};
+  std::atomic<uint64_t> Frames{0};
+  std::atomic<uint64_t> Sends{0};
+
+  static constexpr std::size_t index(LiveTopic Topic) {
+    return static_cast<std::size_t>(Topic);
+  }
+
+  static constexpr uint8_t topicBit(LiveTopic Topic) {
+    return static_cast<uint8_t>(1U << index(Topic));
+  }
+
+  bool listening(LiveTopic Topic) const {
+    return Listeners[index(Topic)].load(std::memory_order_relaxed) != 0;
+  }
+
+  // Drops the listener counts for every topic in Topics. Callers hold
+  // SubscribersMutex exclusively.
+  void release(uint8_t Topics) {
+    for (std::size_t I = 0; I < LiveTopicCount; ++I) {
+      if ((Topics & topicBit(static_cast<LiveTopic>(I))) != 0) {
+        Listeners[I].fetch_sub(1, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  template <typename T>
+  Frame deltaFrame(
+      LiveTopic Topic,
+      const std::unordered_map<core::Uuid, std::shared_ptr<const T>> &Pending
+  ) {
+    LiveDelta<T> Delta{.Topic = LiveTopicNames[index(Topic)]};
+    for (const auto &[Id, Entity] : Pending) {
+      if (Entity->DeletedAt) {
+        Delta.Deleted.push_back(Id);
+      } else {
+        Delta.Upserted.push_back(Entity);
+      }
+    }
+    Delta.Seq = Seq.fetch_add(1, std::memory_order_relaxed) + 1;
+    return serialize(Delta);
+  }
+
+  Frame leaderboardFrame(std::vector<LeaderboardEntry> Top) {
+    LeaderboardFrame Board{
+        .Topic = LiveTopicNames[index(LiveTopic::Leaderboard)],
+        .Seq = Seq.fetch_add(1, std::memory_order_relaxed) + 1,
+        .Top = std::move(Top),
+    };
+    return serialize(Board);
+  }
+
+  template <typename T> Frame serialize(const T &Value) {
+    std::string Buffer;
+    if (auto Error = glz::write_json(Value, Buffer)) {
+      spdlog::error(
+          "LiveHub: failed to serialize frame: {}", glz::format_error(Error)
+      );
+      return nullptr;
+    }
+    return std::make_shared<const std::string>(std::move(Buffer));
+  }
+
+  // Top repositories by stars (ties by Id) from the current snapshot.
+  std::vector<LeaderboardEntry> leaderboard() const {
+    std::vector<LeaderboardEntry> Top;
+    auto Current = Snapshot->current();
+    if (!Current) {
+      return Top;
+    }
+    std::vector<const models::Repository *> Ranked;
+    Ranked.reserve(Current->Repositories.size());
+    for (const auto &Repository : Current->Repositories) {
+      if (!Repository->DeletedAt) {
+        Ranked.push_back(Repository.get());
+      }
+    }
+    auto Count = std::min(Ranked.size(), LeaderboardSize);
+    std::ranges::partial_sort(
+        Ranked, Ranked.begin() + Count, [](const auto *Lhs, const auto *Rhs) {
+          return Lhs->Stars != Rhs->Stars ? Lhs->Stars > Rhs->Stars
+                                          : Lhs->Id < Rhs->Id;
+        }
+    );
+    Top.reserve(Count);
+    for (const auto *Repository : Ranked | std::views::take(Count)) {
+      Top.push_back({
+          .Id = Repository->Id,
+          .Name = Repository->Name,
+          .AccountId = Repository->AccountId,
+          .Stars = Repository->Stars,
+      });
+    }
+    return Top;
+  }
+
+  void broadcast(LiveTopic Topic, const Frame &Payload) {
+    if (!Payload) {
+      return;
+    }
+    Frames.fetch_add(1, std::memory_order_relaxed);
+    auto Bit = topicBit(Topic);
+    std::vector<const void *> Gone;
+    {
+      std::shared_lock Lock(SubscribersMutex);
+      for (const auto &[Key, Client] : Subscribers) {
+        if ((Client.Topics & Bit) == 0) {
+          continue;
+        }
+        if (Client.Send(Payload)) {
+          Sends.fetch_add(1, std::memory_order_relaxed);
+        } else {
+          Gone.push_back(Key);
+        }
+      }
+    }
+    for (const auto *Key : Gone) {
+      disconnect(Key);
+    }
+  }
+};
+
+// Drains the hub on the shared io_context every Interval.
+inline void startLiveFlush(
+    std::shared_ptr<asio::steady_timer> Timer,
+    std::shared_ptr<LiveHub> Hub,
+    std::chrono::milliseconds Interval = std::chrono::milliseconds{100}
+) {
+  auto Handler =
+      std::make_shared<std::function<void(const std::error_code &)>>();
+
+  *Handler = [Handler, Timer, Hub, Interval](const std::error_code &Ec) {
+    if (Ec) {
+      return;
+    }
+    Hub->flush();
+    Timer->expires_after(Interval);
+    Timer->async_wait(*Handler);
+  };
+
+  Timer->expires_after(Interval);
+  Timer->async_wait(*Handler);
+}
+
+} // namespace insights::github
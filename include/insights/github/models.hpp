@@ -1,6 +1,9 @@
 #pragma once
+#include "glaze/core/common.hpp"
+#include "insights/core/fields.hpp"
 #include "insights/core/timestamp.hpp"
 #include "insights/core/traits.hpp"
+#include "insights/core/uuid.hpp"
 
 #include <chrono>
 #include <ctime>
@@ -15,7 +18,7 @@ namespace insights::github::models {
 using Timestamp = std::chrono::system_clock::time_point;
 
 struct Account {
-  std::string Id;
+  core::Uuid Id;
   std::string Name;
   int Followers{0};
   Timestamp CreatedAt;
@@ -23,9 +26,9 @@ struct Account {
   std::optional<Timestamp> DeletedAt;
 };
 struct Repository {
-  std::string Id;
+  core::Uuid Id;
   std::string Name;
-  std::string AccountId;
+  core::Uuid AccountId;
   int Clones{0};
   int Forks{0};
   int Stars{0};
@@ -37,6 +40,39 @@ struct Repository {
 };
 } // namespace insights::github::models
 
+// JSON projections of the models. They emit exactly the fields (and key
+// names) of OutputAccountSchema / OutputRepositorySchema, so routes can
+// serialize models — or the snapshot's shared_ptrs to them — directly
+// instead of copying every row into an output struct first. Timestamps are
+// intentionally not part of the API.
+template <> struct glz::meta<insights::github::models::Account> {
+  using T = insights::github::models::Account;
+  static constexpr auto value =
+      glz::object("Id", &T::Id, "Name", &T::Name, "Followers", &T::Followers);
+};
+
+template <> struct glz::meta<insights::github::models::Repository> {
+  using T = insights::github::models::Repository;
+  static constexpr auto value = glz::object(
+      "Id",
+      &T::Id,
+      "Name",
+      &T::Name,
+      "AccountId",
+      &T::AccountId,
+      "Clones",
+      &T::Clones,
+      "Forks",
+      &T::Forks,
+      "Stars",
+      &T::Stars,
+      "Subscribers",
+      &T::Subscribers,
+      "Views",
+      &T::Views
+  );
+};
+
 namespace insights::core {
 
 template <> struct DbTraits<github::models::Account> {
@@ -45,21 +81,37 @@ template <> struct DbTraits<github::models::Account> {
 
   static constexpr std::string_view UpdateSet = "name=$1, followers=$2";
 
+  // The table's natural key (its UNIQUE constraint), for ON CONFLICT.
+  static constexpr std::string_view ConflictColumns = "name";
+
+  static constexpr auto Fields = std::tuple{
+      core::Field{"Id", "id", &github::models::Account::Id},
+      core::Field{"Name", "name", &github::models::Account::Name},
+      core::Field{
+          "Followers", "followers", &github::models::Account::Followers
+      },
+  };
+
   static auto toParams(const github::models::Account &Account) {
     return std::make_tuple(Account.Name, Account.Followers);
   }
 
-  static github::models::Account fromRow(const pqxx::row &Row) {
+  template <typename RowType>
+  static github::models::Account fromRow(const RowType &Row) {
     return {
-        .Id = Row["id"].as<std::string>(),
-        .Name = Row["name"].as<std::string>(),
-        .Followers = Row["followers"].as<int>(),
-        .CreatedAt = core::parseTimestamp(Row["created_at"].as<std::string>()),
-        .UpdatedAt = core::parseTimestamp(Row["updated_at"].as<std::string>()),
+        .Id = Row["id"].template as<core::Uuid>(),
+        .Name = Row["name"].template as<std::string>(),
+        .Followers = Row["followers"].template as<int>(),
+        .CreatedAt = core::parseTimestamp(
+            Row["created_at"].template as<std::string>()
+        ),
+        .UpdatedAt = core::parseTimestamp(
+            Row["updated_at"].template as<std::string>()
+        ),
         .DeletedAt = Row["deleted_at"].is_null()
                          ? std::nullopt
                          : std::optional{core::parseTimestamp(
-                               Row["deleted_at"].as<std::string>()
+                               Row["deleted_at"].template as<std::string>()
                            )},
     };
   }
@@ -74,6 +126,23 @@ template <> struct DbTraits<github::models::Repository> {
       "name=$1, account_id=$2, clones=$3, forks=$4, stars=$5, subscribers=$6, "
       "views=$7";
 
+  static constexpr std::string_view ConflictColumns = "name, account_id";
+
+  static constexpr auto Fields = std::tuple{
+      core::Field{"Id", "id", &github::models::Repository::Id},
+      core::Field{"Name", "name", &github::models::Repository::Name},
+      core::Field{
+          "AccountId", "account_id", &github::models::Repository::AccountId
+      },
+      core::Field{"Clones", "clones", &github::models::Repository::Clones},
+      core::Field{"Forks", "forks", &github::models::Repository::Forks},
+      core::Field{"Stars", "stars", &github::models::Repository::Stars},
+      core::Field{
+          "Subscribers", "subscribers", &github::models::Repository::Subscribers
+      },
+      core::Field{"Views", "views", &github::models::Repository::Views},
+  };
+
   static auto toParams(const github::models::Repository &Repository) {
     return std::make_tuple(
         Repository.Name,
@@ -86,22 +155,27 @@ template <> struct DbTraits<github::models::Repository> {
     );
   }
 
-  static github::models::Repository fromRow(const pqxx::row &Row) {
+  template <typename RowType>
+  static github::models::Repository fromRow(const RowType &Row) {
     return {
-        .Id = Row["id"].as<std::string>(),
-        .Name = Row["name"].as<std::string>(),
-        .AccountId = Row["account_id"].as<std::string>(),
-        .Clones = Row["clones"].as<int>(),
-        .Forks = Row["forks"].as<int>(),
-        .Stars = Row["stars"].as<int>(),
-        .Subscribers = Row["subscribers"].as<int>(),
-        .Views = Row["views"].as<int>(),
-        .CreatedAt = core::parseTimestamp(Row["created_at"].as<std::string>()),
-        .UpdatedAt = core::parseTimestamp(Row["updated_at"].as<std::string>()),
+        .Id = Row["id"].template as<core::Uuid>(),
+        .Name = Row["name"].template as<std::string>(),
+        .AccountId = Row["account_id"].template as<core::Uuid>(),
+        .Clones = Row["clones"].template as<int>(),
+        .Forks = Row["forks"].template as<int>(),
+        .Stars = Row["stars"].template as<int>(),
+        .Subscribers = Row["subscribers"].template as<int>(),
+        .Views = Row["views"].template as<int>(),
+        .CreatedAt = core::parseTimestamp(
+            Row["created_at"].template as<std::string>()
+        ),
+        .UpdatedAt = core::parseTimestamp(
+            Row["updated_at"].template as<std::string>()
+        ),
         .DeletedAt = Row["deleted_at"].is_null()
                          ? std::nullopt
                          : std::optional{core::parseTimestamp(
-                               Row["deleted_at"].as<std::string>()
+                               Row["deleted_at"].template as<std::string>()
                            )},
     };
   }
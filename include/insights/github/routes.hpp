@@ -1,13 +1,21 @@
 #pragma once
 #include "glaze/net/http_router.hpp"
+#include "glaze/net/websocket_connection.hpp"
 #include "insights/core/config.hpp"
 #include "insights/core/result.hpp"
+#include "insights/core/uuid.hpp"
 #include "insights/db/db.hpp"
+#include "insights/github/state.hpp"
+#include "insights/github/stats.hpp"
+#include "insights/github/tasks.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <expected>
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace insights::github {
 
@@ -27,15 +35,15 @@ struct CreateRepositorySchema {
 };
 
 struct OutputAccountSchema {
-  std::string Id;
+  core::Uuid Id;
   std::string Name;
   int Followers{0};
 };
 
 struct OutputRepositorySchema {
-  std::string Id;
+  core::Uuid Id;
   std::string Name;
-  std::string AccountId;
+  core::Uuid AccountId;
   int Clones{0};
   int Forks{0};
   int Stars{0};
@@ -43,15 +51,75 @@ struct OutputRepositorySchema {
   long long Views{0};
 };
 
+// GET /stats: StatCounters over all live entities, and per account (an
+// account's own Followers plus the sums of its repositories).
+struct AccountStatsSchema {
+  core::Uuid AccountId;
+  int64_t Repositories{0};
+  int64_t Stars{0};
+  int64_t Forks{0};
+  int64_t Views{0};
+  int64_t Clones{0};
+  int64_t Followers{0};
+};
+
+struct StatsResponse {
+  StatCounters Totals;
+  std::vector<AccountStatsSchema> Accounts;
+  std::optional<std::string> ReconciledAt;
+};
+
+// GET /search?q=&limit=: name matches for type-ahead, best first (see
+// SearchIndex for the ranking). At most limit of each kind.
+inline constexpr std::size_t DefaultSearchLimit = 10;
+inline constexpr std::size_t MaxSearchLimit = 50;
+inline constexpr std::size_t MaxSearchQueryLength = 100;
+
+struct SearchResponse {
+  std::string Query;
+  std::vector<OutputRepositorySchema> Repositories;
+  std::vector<OutputAccountSchema> Accounts;
+};
+
 struct SyncRepositoryResponse {
   std::string Status;
   std::string Summary;
   OutputRepositorySchema Repository;
 };
 
+// POST /accounts:bulk and /repos:bulk take a JSON array of Create*Schema
+// items and answer with one result per item, in input order. Status is
+// "created", "existing" (the natural key was already taken; Id is the
+// existing row, which is left unchanged) or "invalid" (Error says why,
+// including a key still held by a soft-deleted row; nothing was written).
+inline constexpr std::size_t MaxBulkItems = 1000;
+
+struct BulkItemResult {
+  std::string Status;
+  std::optional<core::Uuid> Id;
+  std::optional<std::string> Error;
+};
+
+struct BulkResponse {
+  std::size_t Created{0};
+  std::size_t Existing{0};
+  std::size_t Invalid{0};
+  std::vector<BulkItemResult> Results;
+};
+
+// Sync hooks that keep the route-level read state (snapshot, response cache)
+// in step with entity updates committed by the GitHub sync.
+auto makeSyncHooks(std::shared_ptr<ReadState> State) -> tasks::SyncHooks;
+
+// The /live WebSocket endpoint: clients send LiveCommand messages to pick
+// topics and receive the hub's frames for them.
+auto createLiveServer(std::shared_ptr<LiveHub> Hub)
+    -> std::shared_ptr<glz::websocket_server>;
+
 auto registerRoutes(
     glz::http_router &Router,
     std::shared_ptr<db::Database> &Database,
+    std::shared_ptr<ReadState> State,
     const core::Config &Config
 ) -> std::expected<void, core::Error>;
 
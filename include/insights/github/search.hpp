@@ -0,0 +1,361 @@
+#pragma once
+#include "insights/core/contention.hpp"
+#include "insights/core/uuid.hpp"
+#include "insights/github/models.hpp"
+#include "insights/github/snapshot.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace insights::github {
+
+struct SearchResults {
+  std::vector<std::shared_ptr<const models::Repository>> Repositories;
+  std::vector<std::shared_ptr<const models::Account>> Accounts;
+};
+
+// ASCII-lowercased copy of Text, the form names are indexed and queried in.
+inline std::string lowerName(std::string_view Text) {
+  std::string Lower(Text);
+  for (auto &Ch : Lower) {
+    if (Ch >= 'A' && Ch <= 'Z') {
+      Ch = static_cast<char>(Ch - 'A' + 'a');
+    }
+  }
+  return Lower;
+}
+
+// Type-ahead index over the names of live accounts and repositories, for
+// GET /search.
+//
+// Each side keeps its lowercased names in a sorted array, so a prefix is one
+// binary search followed by a contiguous range, and posting lists from every
+// trigram (three consecutive bytes) of a name to the entries containing it,
+// for matches inside a name and near misses. Results are ranked in tiers —
+// prefix matches, then names containing the query, then names sharing at
+// least half of its trigrams (most shared first) — and by stars
+// (repositories) or followers (accounts) within a tier. Queries shorter
+// than a trigram match prefixes only.
+//
+// Writes are applied incrementally: the sorted array and postings change
+// only when a name appears, is renamed or goes away (soft delete); any other
+// update just swaps the held entity, so rankings read current counters.
+// load() builds both sides from the snapshot. Until then search() returns
+// nullopt and writes are dropped, as with SnapshotStore.
+struct SearchIndex {
+  // Builds the index from Store's current snapshot; false if none is
+  // loaded. The snapshot is read under the index lock, so a write that
+  // races with the load is either in that snapshot or applied after it.
+  bool load(const SnapshotStore &Store) {
+    std::unique_lock Lock(Mutex);
+    auto Current = Store.current();
+    if (!Current) {
+      return false;
+    }
+    build(*Current);
+    return true;
+  }
+
+  // Builds the index from a snapshot that no writer can race with.
+  void load(const Snapshot &Current) {
+    std::unique_lock Lock(Mutex);
+    build(Current);
+  }
+
+  void apply(const models::Account &Account) {
+    std::unique_lock Lock(Mutex);
+    if (Loaded) {
+      Accounts.upsert(Account);
+    }
+  }
+
+  void apply(const models::Repository &Repository) {
+    std::unique_lock Lock(Mutex);
+    if (Loaded) {
+      Repositories.upsert(Repository);
+    }
+  }
+
+  // At most Limit matches of each kind for Query, compared
+  // case-insensitively.
+  std::optional<SearchResults>
+  search(std::string_view Query, std::size_t Limit) const {
+    auto Lower = lowerName(Query);
+    std::shared_lock Lock(Mutex);
+    if (!Loaded) {
+      return std::nullopt;
+    }
+    return SearchResults{
+        .Repositories = Repositories.search(Lower, Limit),
+        .Accounts = Accounts.search(Lower, Limit),
+    };
+  }
+
+private:
+  struct LockTag {
+    static constexpr std::string_view Name = "search";
+  };
+
+  // Tier 0 is a prefix match, 1 a substring match and 2 a fuzzy match,
+  // where Shared (the query trigrams found in the name) ranks closer misses
+  // first.
+  struct Match {
+    uint8_t Tier{0};
+    uint32_t Shared{0};
+    uint32_t Slot{0};
+  };
+
+  template <typename T> struct Table {
+    struct Entry {
+      std::string Key; // Lowercased name.
+      int64_t Rank{0}; // Stars or followers, kept inline for sorting.
+      std::shared_ptr<const T> Entity;
+    };
+
+    // Slots of removed entities are reused, so ids stay small and dense.
+    std::vector<Entry> Entries;
+    std::vector<uint32_t> Free;
+    std::unordered_map<core::Uuid, uint32_t> ById;
+    std::vector<uint32_t> ByKey;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> Postings;
+
+    void build(const std::vector<std::shared_ptr<const T>> &Entities) {
+      Entries.clear();
+      Free.clear();
+      ById.clear();
+      ByKey.clear();
+      Postings.clear();
+      Entries.reserve(Entities.size());
+      ById.reserve(Entities.size());
+      for (const auto &Entity : Entities) {
+        if (Entity->DeletedAt) {
+          continue;
+        }
+        auto Slot = static_cast<uint32_t>(Entries.size());
+        Entries.push_back({
+            .Key = lowerName(Entity->Name),
+            .Rank = rank(*Entity),
+            .Entity = Entity,
+        });
+        ById.emplace(Entity->Id, Slot);
+        ByKey.push_back(Slot);
+        for (auto Trigram : trigrams(Entries.back().Key)) {
+          Postings[Trigram].push_back(Slot);
+        }
+      }
+      std::ranges::sort(ByKey, [this](uint32_t A, uint32_t B) {
+        return Entries[A].Key < Entries[B].Key;
+      });
+    }
+
+    void upsert(const T &Entity) {
+      auto Found = ById.find(Entity.Id);
+      if (Entity.DeletedAt) {
+        if (Found != ById.end()) {
+          unlink(Found->second);
+          Entries[Found->second] = {};
+          Free.push_back(Found->second);
+          ById.erase(Found);
+        }
+        return;
+      }
+
+      auto Held = std::make_shared<const T>(Entity);
+      auto Key = lowerName(Entity.Name);
+      if (Found != ById.end()) {
+        auto &Current = Entries[Found->second];
+        Current.Rank = rank(Entity);
+        Current.Entity = std::move(Held);
+        if (Current.Key != Key) {
+          unlink(Found->second);
+          Current.Key = std::move(Key);
+          link(Found->second);
+        }
+        return;
+      }
+
+      uint32_t Slot = 0;
+      if (Free.empty()) {
+        Slot = static_cast<uint32_t>(Entries.size());
+        Entries.emplace_back();
+      } else {
+        Slot = Free.back();
+        Free.pop_back();
+      }
+      Entries[Slot] = {
+          .Key = std::move(Key),
+          .Rank = rank(Entity),
+          .Entity = std::move(Held),
+      };
+      ById.emplace(Entity.Id, Slot);
+      link(Slot);
+    }
+
+    std::vector<std::shared_ptr<const T>>
+    search(const std::string &Query, std::size_t Limit) const {
+      std::vector<Match> Matches;
+
+      auto From = std::ranges::lower_bound(
+          ByKey, Query, std::less<>{}, [this](uint32_t Slot) -> const auto & {
+            return Entries[Slot].Key;
+          }
+      );
+      for (auto It = From;
+           It != ByKey.end() && Entries[*It].Key.starts_with(Query);
+           ++It) {
+        Matches.push_back({.Tier = 0, .Slot = *It});
+      }
+
+      // Prefix matches rank first; when they fill the page, the other tiers
+      // could not make it in.
+      auto Wanted = trigrams(Query);
+      if (!Wanted.empty() && Matches.size() < Limit) {
+        // Dense counters: a common trigram can hit most entries, which a
+        // hash map would make the slowest part of the query.
+        std::vector<uint32_t> Hits(Entries.size());
+        std::vector<uint32_t> Touched;
+        for (auto Trigram : Wanted) {
+          if (auto It = Postings.find(Trigram); It != Postings.end()) {
+            for (auto Slot : It->second) {
+              if (Hits[Slot]++ == 0) {
+                Touched.push_back(Slot);
+              }
+            }
+          }
+        }
+        for (auto Slot : Touched) {
+          auto Count = Hits[Slot];
+          const auto &Key = Entries[Slot].Key;
+          if (Key.starts_with(Query)) {
+            continue;
+          }
+          if (Count == Wanted.size() &&
+              Key.find(Query) != std::string::npos) {
+            Matches.push_back({.Tier = 1, .Slot = Slot});
+          } else if (Count * 2 >= Wanted.size()) {
+            Matches.push_back({.Tier = 2, .Shared = Count, .Slot = Slot});
+          }
+        }
+      }
+
+      auto Ranked = std::min(Limit, Matches.size());
+      std::partial_sort(
+          Matches.begin(),
+          Matches.begin() + static_cast<std::ptrdiff_t>(Ranked),
+          Matches.end(),
+          [this](const Match &A, const Match &B) {
+            if (A.Tier != B.Tier) {
+              return A.Tier < B.Tier;
+            }
+            if (A.Shared != B.Shared) {
+              return A.Shared > B.Shared;
+            }
+            const auto &Left = Entries[A.Slot];
+            const auto &Right = Entries[B.Slot];
+            if (Left.Rank != Right.Rank) {
+              return Left.Rank > Right.Rank;
+            }
+            return Left.Key < Right.Key;
+          }
+      );
+
+      std::vector<std::shared_ptr<const T>> Results;
+      Results.reserve(Ranked);
+      for (std::size_t I = 0; I < Ranked; ++I) {
+        Results.push_back(Entries[Matches[I].Slot].Entity);
+      }
+      return Results;
+    }
+
+  private:
+    void link(uint32_t Slot) {
+      const auto &Key = Entries[Slot].Key;
+      auto At = std::ranges::upper_bound(
+          ByKey, Key, std::less<>{}, [this](uint32_t Other) -> const auto & {
+            return Entries[Other].Key;
+          }
+      );
+      ByKey.insert(At, Slot);
+      for (auto Trigram : trigrams(Key)) {
+        Postings[Trigram].push_back(Slot);
+      }
+    }
+
+    void unlink(uint32_t Slot) {
+      const auto &Key = Entries[Slot].Key;
+      auto [From, To] = std::ranges::equal_range(
+          ByKey, Key, std::less<>{}, [this](uint32_t Other) -> const auto & {
+            return Entries[Other].Key;
+          }
+      );
+      if (auto It = std::find(From, To, Slot); It != To) {
+        ByKey.erase(It);
+      }
+      for (auto Trigram : trigrams(Key)) {
+        auto Posting = Postings.find(Trigram);
+        if (Posting == Postings.end()) {
+          continue;
+        }
+        auto &Slots = Posting->second;
+        if (auto It = std::ranges::find(Slots, Slot); It != Slots.end()) {
+          *It = Slots.back();
+          Slots.pop_back();
+        }
+        if (Slots.empty()) {
+          Postings.erase(Posting);
+        }
+      }
+    }
+  };
+
+  mutable core::CountedMutex<std::shared_mutex, LockTag> Mutex;
+  Table<models::Account> Accounts;
+  Table<models::Repository> Repositories;
+  bool Loaded{false};
+
+  void build(const Snapshot &Current) {
+    Accounts.build(Current.Accounts);
+    Repositories.build(Current.Repositories);
+    Loaded = true;
+  }
+
+  static int64_t rank(const models::Account &Account) {
+    return Account.Followers;
+  }
+
+  static int64_t rank(const models::Repository &Repository) {
+    return Repository.Stars;
+  }
+
+  // Distinct trigrams of an already lowercased Key, packed into the low 24
+  // bits.
+  static std::vector<uint32_t> trigrams(std::string_view Key) {
+    std::vector<uint32_t> Trigrams;
+    if (Key.size() < 3) {
+      return Trigrams;
+    }
+    Trigrams.reserve(Key.size() - 2);
+    for (std::size_t I = 0; I + 3 <= Key.size(); ++I) {
+      Trigrams.push_back(
+          static_cast<uint32_t>(static_cast<unsigned char>(Key[I])) << 16 |
+          static_cast<uint32_t>(static_cast<unsigned char>(Key[I + 1])) << 8 |
+          static_cast<uint32_t>(static_cast<unsigned char>(Key[I + 2]))
+      );
+    }
+    std::ranges::sort(Trigrams);
+    auto Duplicates = std::ranges::unique(Trigrams);
+    Trigrams.erase(Duplicates.begin(), Duplicates.end());
+    return Trigrams;
+  }
+};
+
+} // namespace insights::github
@@ -0,0 +1,337 @@
+#pragma once
+#include "insights/core/contention.hpp"
+#include "insights/core/flat_index.hpp"
+#include "insights/core/result.hpp"
+#include "insights/core/uuid.hpp"
+#include "insights/db/db.hpp"
+#include "insights/github/models.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <spdlog/spdlog.h>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace insights::github {
+
+// Immutable view of every tracked account and repository, soft-deleted
+// ones included so by-id reads and the stats diffs still see them; list
+// routes skip rows with DeletedAt set.
+//
+// Entities are held by shared_ptr and sorted by Id, so publishing a new
+// snapshot after a write copies pointers only — unchanged entities are
+// shared between the old and new versions.
+//
+// Live (not soft-deleted) entities are also indexed by case-insensitive
+// name: accounts by Name, repositories by (AccountId, Name), so an
+// "owner/name" lookup is two hash probes. The indexes hold raw pointers into
+// the entities this snapshot owns and are kept current by SnapshotStore.
+struct Snapshot {
+  std::vector<std::shared_ptr<const models::Account>> Accounts;
+  std::vector<std::shared_ptr<const models::Repository>> Repositories;
+
+  std::shared_ptr<const models::Account>
+  account(const core::Uuid &Id) const {
+    return find(Accounts, Id);
+  }
+
+  std::shared_ptr<const models::Repository>
+  repository(const core::Uuid &Id) const {
+    return find(Repositories, Id);
+  }
+
+  // Valid while this snapshot is held.
+  const models::Account *accountByName(std::string_view Name) const {
+    return AccountsByName.find(
+        nameKey(Name),
+        [Name](const models::Account &Account) {
+          return core::equalsLower(Account.Name, Name);
+        }
+    );
+  }
+
+  const models::Repository *
+  repositoryByName(std::string_view Owner, std::string_view Name) const {
+    const auto *Account = accountByName(Owner);
+    if (Account == nullptr) {
+      return nullptr;
+    }
+    return RepositoriesByName.find(
+        nameKey(Account->Id, Name),
+        [&](const models::Repository &Repository) {
+          return Repository.AccountId == Account->Id &&
+                 core::equalsLower(Repository.Name, Name);
+        }
+    );
+  }
+
+private:
+  friend struct SnapshotStore;
+
+  core::FlatIndex<models::Account> AccountsByName;
+  core::FlatIndex<models::Repository> RepositoriesByName;
+
+  static uint64_t nameKey(std::string_view Name) {
+    return core::hashLower(Name);
+  }
+
+  static uint64_t nameKey(const core::Uuid &AccountId, std::string_view Name) {
+    return core::hashLower(Name, std::hash<core::Uuid>{}(AccountId));
+  }
+
+  static uint64_t nameKey(const models::Account &Account) {
+    return nameKey(Account.Name);
+  }
+
+  static uint64_t nameKey(const models::Repository &Repository) {
+    return nameKey(Repository.AccountId, Repository.Name);
+  }
+
+  // Swaps Previous for Current in the name index of T; either may be null.
+  template <typename T>
+  static void reindex(
+      core::FlatIndex<T> &Index, const T *Previous, const T *Current
+  ) {
+    if (Previous != nullptr && !Previous->DeletedAt) {
+      Index.erase(nameKey(*Previous), Previous);
+    }
+    if (Current != nullptr && !Current->DeletedAt) {
+      Index.insert(nameKey(*Current), Current);
+    }
+  }
+
+  void reindexAll() {
+    AccountsByName = {};
+    AccountsByName.reserve(Accounts.size());
+    for (const auto &Account : Accounts) {
+      reindex<models::Account>(AccountsByName, nullptr, Account.get());
+    }
+    RepositoriesByName = {};
+    RepositoriesByName.reserve(Repositories.size());
+    for (const auto &Repository : Repositories) {
+      reindex<models::Repository>(
+          RepositoriesByName, nullptr, Repository.get()
+      );
+    }
+  }
+
+  template <typename T>
+  static std::shared_ptr<const T> find(
+      const std::vector<std::shared_ptr<const T>> &Entities,
+      const core::Uuid &Id
+  ) {
+    auto It = std::ranges::lower_bound(
+        Entities, Id, std::less<>{}, [](const auto &Entity) -> const auto & {
+          return Entity->Id;
+        }
+    );
+    if (It == Entities.end() || (*It)->Id != Id) {
+      return nullptr;
+    }
+    return *It;
+  }
+};
+
+// Publishes Snapshot versions RCU-style: readers atomically load the current
+// pointer and never block; writers copy it, apply their change and swap the
+// new version in. Writers are serialized by WriteMutex so concurrent updates
+// are never lost.
+//
+// The store starts empty (current() == nullptr) until load() succeeds;
+// callers fall back to the database until then.
+struct SnapshotStore {
+  std::shared_ptr<const Snapshot> current() const {
+    return std::atomic_load_explicit(&Current, std::memory_order_acquire);
+  }
+
+  std::expected<void, core::Error> load(db::Database &Database) {
+    auto Accounts = Database.getAll<models::Account>(db::RowFilter::All);
+    if (!Accounts) {
+      return std::unexpected(Accounts.error());
+    }
+    auto Repositories =
+        Database.getAll<models::Repository>(db::RowFilter::All);
+    if (!Repositories) {
+      return std::unexpected(Repositories.error());
+    }
+
+    auto Next = std::make_shared<Snapshot>();
+    Next->Accounts.reserve(Accounts->size());
+    for (auto &Account : *Accounts) {
+      Next->Accounts.push_back(
+          std::make_shared<const models::Account>(std::move(Account))
+      );
+    }
+    Next->Repositories.reserve(Repositories->size());
+    for (auto &Repository : *Repositories) {
+      Next->Repositories.push_back(
+          std::make_shared<const models::Repository>(std::move(Repository))
+      );
+    }
+    sortById(Next->Accounts);
+    sortById(Next->Repositories);
+    Next->reindexAll();
+
+    std::scoped_lock Lock(WriteMutex);
+    publish(std::move(Next));
+    spdlog::info(
+        "SnapshotStore::load - Loaded {} accounts, {} repositories",
+        Accounts->size(),
+        Repositories->size()
+    );
+    return {};
+  }
+
+  // What apply() did with one entity. Previous is the version it replaced
+  // (nullptr for a new entity). Stale is set when the snapshot already held
+  // a later version of the row, which is kept; Previous is then that later
+  // version, and callers must not fold the stale one into anything else.
+  template <typename T> struct Applied {
+    std::shared_ptr<const T> Previous;
+    bool Stale{false};
+  };
+
+  // nullopt while the store is not loaded and nothing was applied.
+  template <typename T> using Replaced = std::optional<Applied<T>>;
+
+  // Inserts or replaces the entity with the same Id, unless the snapshot
+  // holds a later version (see isStale): writes are recorded after their
+  // transaction commits, so two writes to one row can arrive out of order.
+  // Soft-deleted rows are kept (with DeletedAt set) so by-id reads and the
+  // stats diffs still see them.
+  Replaced<models::Account> apply(const models::Account &Account) {
+    return applyOne(Account);
+  }
+
+  Replaced<models::Repository> apply(const models::Repository &Repository) {
+    return applyOne(Repository);
+  }
+
+  // Applies a batch (a bulk insert) under one copy of the snapshot instead
+  // of one copy per row; new rows are merged in with a single pass. Results
+  // are per entity, in order. Entities must not repeat an Id.
+  std::optional<std::vector<Applied<models::Account>>>
+  apply(std::span<const models::Account> Accounts) {
+    return applyMany(Accounts);
+  }
+
+  std::optional<std::vector<Applied<models::Repository>>>
+  apply(std::span<const models::Repository> Repositories) {
+    return applyMany(Repositories);
+  }
+
+private:
+  std::shared_ptr<const Snapshot> Current;
+  struct LockTag {
+    static constexpr std::string_view Name = "snapshot_write";
+  };
+
+  core::CountedMutex<std::mutex, LockTag> WriteMutex;
+
+  void publish(std::shared_ptr<const Snapshot> Next) {
+    std::atomic_store_explicit(
+        &Current, std::move(Next), std::memory_order_release
+    );
+  }
+
+  template <typename T>
+  static void sortById(std::vector<std::shared_ptr<const T>> &Entities) {
+    std::ranges::sort(
+        Entities,
+        std::less<>{},
+        [](const auto &Entity) -> const auto & { return Entity->Id; }
+    );
+  }
+
+  template <typename T> static auto &entities(Snapshot &Next) {
+    if constexpr (std::is_same_v<T, models::Account>) {
+      return Next.Accounts;
+    } else {
+      return Next.Repositories;
+    }
+  }
+
+  template <typename T> static auto &nameIndex(Snapshot &Next) {
+    if constexpr (std::is_same_v<T, models::Account>) {
+      return Next.AccountsByName;
+    } else {
+      return Next.RepositoriesByName;
+    }
+  }
+
+  // True when Incoming is an older version of the row than Existing. A
+  // soft delete is final and leaves updated_at alone, so deleted beats live
+  // either way; otherwise the later UpdatedAt wins and a tie applies.
+  template <typename T>
+  static bool isStale(const T &Incoming, const T &Existing) {
+    if (Incoming.DeletedAt.has_value() != Existing.DeletedAt.has_value()) {
+      return Existing.DeletedAt.has_value();
+    }
+    return Incoming.UpdatedAt < Existing.UpdatedAt;
+  }
+
+  template <typename T> Replaced<T> applyOne(const T &Entity) {
+    auto Results = applyMany(std::span<const T>(&Entity, 1));
+    if (!Results) {
+      return std::nullopt;
+    }
+    return std::move(Results->front());
+  }
+
+  template <typename T>
+  std::optional<std::vector<Applied<T>>>
+  applyMany(std::span<const T> Batch) {
+    std::scoped_lock Lock(WriteMutex);
+    auto Base = current();
+    if (!Base) {
+      return std::nullopt;
+    }
+    auto Next = std::make_shared<Snapshot>(*Base);
+    auto &Entities = entities<T>(*Next);
+    auto &Index = nameIndex<T>(*Next);
+    auto IdOf = [](const auto &Entity) -> const auto & { return Entity->Id; };
+
+    std::vector<Applied<T>> Results(Batch.size());
+    std::vector<std::shared_ptr<const T>> Added;
+    for (std::size_t I = 0; I < Batch.size(); ++I) {
+      const auto &Entity = Batch[I];
+      auto It =
+          std::ranges::lower_bound(Entities, Entity.Id, std::less<>{}, IdOf);
+      if (It == Entities.end() || (*It)->Id != Entity.Id) {
+        Added.push_back(std::make_shared<const T>(Entity));
+        Snapshot::reindex<T>(Index, nullptr, Added.back().get());
+        continue;
+      }
+      if (isStale(Entity, **It)) {
+        Results[I] = {.Previous = *It, .Stale = true};
+        continue;
+      }
+      Results[I].Previous =
+          std::exchange(*It, std::make_shared<const T>(Entity));
+      Snapshot::reindex<T>(Index, Results[I].Previous.get(), It->get());
+    }
+    if (!Added.empty()) {
+      sortById(Added);
+      std::vector<std::shared_ptr<const T>> Merged;
+      Merged.reserve(Entities.size() + Added.size());
+      std::ranges::merge(
+          Entities, Added, std::back_inserter(Merged), std::less<>{}, IdOf, IdOf
+      );
+      Entities = std::move(Merged);
+    }
+    publish(std::move(Next));
+    return Results;
+  }
+};
+
+} // namespace insights::github
@@ -0,0 +1,101 @@
+#pragma once
+#include "insights/core/cache.hpp"
+#include "insights/github/cache.hpp"
+#include "insights/github/live.hpp"
+#include "insights/github/models.hpp"
+#include "insights/github/search.hpp"
+#include "insights/github/snapshot.hpp"
+#include "insights/github/stats.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+
+namespace insights::github {
+
+// In-memory read state served by the github routes. Every committed write —
+// from a route handler or from the sync — must be reported through
+// recordAccount/recordRepository so each piece stays consistent with the
+// database. Stats, Search and Live are optional; when set, committed entities
+// also adjust the aggregate counters, update the name search index and are
+// pushed to WebSocket subscribers.
+struct ReadState {
+  std::shared_ptr<core::ResponseCache> Cache;
+  std::shared_ptr<SnapshotStore> Snapshot;
+  std::shared_ptr<StatsStore> Stats;
+  std::shared_ptr<SearchIndex> Search;
+  std::shared_ptr<LiveHub> Live;
+};
+
+namespace detail {
+
+// Folds one committed entity into the cache and the derived state, given
+// what the snapshot did with it (nullopt before the snapshot is loaded).
+template <typename T>
+void fold(
+    ReadState &State,
+    const T &Entity,
+    const SnapshotStore::Replaced<T> &Applied
+) {
+  // The snapshot is published before invalidating, so a cache miss that
+  // follows rebuilds the body from the updated entity.
+  if constexpr (std::is_same_v<T, models::Account>) {
+    cache::invalidateAccount(*State.Cache, Entity.Id);
+  } else {
+    cache::invalidateRepository(*State.Cache, Entity.Id);
+  }
+  // A later version of the row was recorded first; it already updated
+  // everything below.
+  if (Applied && Applied->Stale) {
+    return;
+  }
+  // Without a snapshot there is no previous version to diff against; the
+  // next reconciliation picks the write up instead.
+  if (State.Stats && Applied) {
+    State.Stats->apply(Applied->Previous.get(), Entity);
+  }
+  if (State.Search) {
+    State.Search->apply(Entity);
+  }
+  if (State.Live) {
+    State.Live->publish(Entity);
+  }
+}
+
+template <typename T>
+void foldAll(ReadState &State, std::span<const T> Entities) {
+  auto Applied = State.Snapshot->apply(Entities);
+  for (std::size_t I = 0; I < Entities.size(); ++I) {
+    SnapshotStore::Replaced<T> One;
+    if (Applied) {
+      One = (*Applied)[I];
+    }
+    fold(State, Entities[I], One);
+  }
+}
+
+} // namespace detail
+
+inline void recordAccount(ReadState &State, const models::Account &Account) {
+  detail::fold(State, Account, State.Snapshot->apply(Account));
+}
+
+inline void
+recordRepository(ReadState &State, const models::Repository &Repository) {
+  detail::fold(State, Repository, State.Snapshot->apply(Repository));
+}
+
+// Batch forms for bulk inserts: one snapshot copy for the whole batch.
+inline void
+recordAccounts(ReadState &State, std::span<const models::Account> Accounts) {
+  detail::foldAll(State, Accounts);
+}
+
+inline void recordRepositories(
+    ReadState &State, std::span<const models::Repository> Repositories
+) {
+  detail::foldAll(State, Repositories);
+}
+
+} // namespace insights::github
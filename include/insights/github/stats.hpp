@@ -0,0 +1,346 @@
+#pragma once
+#include "insights/core/contention.hpp"
+#include "insights/core/result.hpp"
+#include "insights/core/timestamp.hpp"
+#include "insights/core/uuid.hpp"
+#include "insights/db/db.hpp"
+#include "insights/github/models.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <pqxx/pqxx>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <stop_token>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace insights::github {
+
+// Sums over live (not soft-deleted) entities. Accounts is only meaningful
+// in the overall totals; per account it is 1 while the account is live.
+struct StatCounters {
+  int64_t Accounts{0};
+  int64_t Repositories{0};
+  int64_t Stars{0};
+  int64_t Forks{0};
+  int64_t Views{0};
+  int64_t Clones{0};
+  int64_t Followers{0};
+
+  StatCounters &operator+=(const StatCounters &Other) {
+    Accounts += Other.Accounts;
+    Repositories += Other.Repositories;
+    Stars += Other.Stars;
+    Forks += Other.Forks;
+    Views += Other.Views;
+    Clones += Other.Clones;
+    Followers += Other.Followers;
+    return *this;
+  }
+
+  StatCounters &operator-=(const StatCounters &Other) {
+    Accounts -= Other.Accounts;
+    Repositories -= Other.Repositories;
+    Stars -= Other.Stars;
+    Forks -= Other.Forks;
+    Views -= Other.Views;
+    Clones -= Other.Clones;
+    Followers -= Other.Followers;
+    return *this;
+  }
+
+  bool operator==(const StatCounters &) const = default;
+};
+
+struct StatsView {
+  StatCounters Totals;
+  std::vector<std::pair<core::Uuid, StatCounters>> Accounts;
+  std::optional<std::string> ReconciledAt;
+};
+
+// What one entity adds to the counters of its account.
+inline StatCounters contribution(const models::Account &Account) {
+  if (Account.DeletedAt) {
+    return {};
+  }
+  return {.Accounts = 1, .Followers = Account.Followers};
+}
+
+inline StatCounters contribution(const models::Repository &Repository) {
+  if (Repository.DeletedAt) {
+    return {};
+  }
+  return {
+      .Repositories = 1,
+      .Stars = Repository.Stars,
+      .Forks = Repository.Forks,
+      .Views = Repository.Views,
+      .Clones = Repository.Clones,
+  };
+}
+
+// Aggregate totals for GET /stats, overall and per account.
+//
+// Writes adjust them by the difference between an entity's previous and
+// new version (recordAccount/recordRepository pass the version the
+// snapshot replaced), so a read is a copy of a few integers rather than a
+// SUM() over both tables. load() rebuilds them from one aggregate query at
+// startup, and startReconciliation() repeats it periodically to correct
+// any drift (e.g. writes made while the snapshot was unavailable). Drift
+// is corrected per account, and only once the same difference shows up in
+// two rounds, so writes in flight during a query are neither counted
+// twice nor able to hold reconciliation off.
+struct StatsStore {
+  // Applies New over Previous (nullptr for a newly created entity).
+  template <typename T> void apply(const T *Previous, const T &New) {
+    std::scoped_lock Lock(Mutex);
+    if (Previous != nullptr) {
+      adjust(accountOf(*Previous), contribution(*Previous), false);
+    }
+    adjust(accountOf(New), contribution(New), true);
+  }
+
+  StatsView view() const {
+    std::scoped_lock Lock(Mutex);
+    StatsView View{.Totals = Totals, .ReconciledAt = ReconciledAt};
+    View.Accounts.assign(PerAccount.begin(), PerAccount.end());
+    std::ranges::sort(
+        View.Accounts,
+        std::less<>{},
+        [](const auto &Entry) -> const auto & { return Entry.first; }
+    );
+    return View;
+  }
+
+  std::expected<void, core::Error> load(db::Database &Database) {
+    auto Fresh = query(Database);
+    if (!Fresh) {
+      return std::unexpected(Fresh.error());
+    }
+    reconcile(*Fresh);
+    return {};
+  }
+
+  // Re-runs load() every Interval on a thread the store owns, each time on
+  // a short-lived connection of its own: the aggregate scans both tables,
+  // so it must neither hold a server thread nor queue handlers behind it
+  // on the shared connection. Stopped and joined when the store goes away;
+  // calling it again replaces the running loop.
+  void startReconciliation(
+      std::string DatabaseUrl,
+      std::chrono::seconds Interval = std::chrono::minutes{10}
+  ) {
+    Reconciler = std::jthread([this, DatabaseUrl = std::move(DatabaseUrl),
+                               Interval](std::stop_token Stop) {
+      std::mutex WaitMutex;
+      std::condition_variable_any Wake;
+      while (true) {
+        {
+          std::unique_lock Lock(WaitMutex);
+          Wake.wait_for(Lock, Stop, Interval, [] { return false; });
+        }
+        if (Stop.stop_requested()) {
+          return;
+        }
+        auto Connection = db::Database::connect(DatabaseUrl);
+        if (!Connection) {
+          spdlog::warn(
+              "Stats reconciliation failed: {}", Connection.error().Message
+          );
+          continue;
+        }
+        if (auto Loaded = load(**Connection); !Loaded) {
+          spdlog::warn(
+              "Stats reconciliation failed: {}", Loaded.error().Message
+          );
+        }
+      }
+    });
+  }
+
+  // Stops and joins the reconciliation thread, e.g. before
+  // spdlog::shutdown().
+  void stopReconciliation() { Reconciler = {}; }
+
+private:
+  using AccountCounters = std::unordered_map<core::Uuid, StatCounters>;
+
+  struct LockTag {
+    static constexpr std::string_view Name = "stats";
+  };
+
+  // An account whose counters differed from the last query, and for how
+  // many rounds in a row.
+  struct Unsettled {
+    StatCounters Difference;
+    uint32_t Rounds{0};
+  };
+
+  static constexpr uint32_t WarnUnsettledRounds = 3;
+
+  mutable core::CountedMutex<std::mutex, LockTag> Mutex;
+  StatCounters Totals;
+  AccountCounters PerAccount;
+  std::unordered_map<core::Uuid, Unsettled> Pending;
+  std::optional<std::string> ReconciledAt;
+  // Last, so it is joined before the state it reads is destroyed.
+  std::jthread Reconciler;
+
+  static const core::Uuid &accountOf(const models::Account &Account) {
+    return Account.Id;
+  }
+
+  static const core::Uuid &accountOf(const models::Repository &Repository) {
+    return Repository.AccountId;
+  }
+
+  // Corrects the counters of every account whose difference from Fresh
+  // (the aggregate query's result) is drift rather than a write in flight.
+  void reconcile(const AccountCounters &Fresh) {
+    std::scoped_lock Lock(Mutex);
+    std::vector<std::pair<core::Uuid, StatCounters>> Differences;
+    for (const auto &[Id, Counters] : Fresh) {
+      auto Difference = Counters;
+      if (auto It = PerAccount.find(Id); It != PerAccount.end()) {
+        Difference -= It->second;
+      }
+      if (Difference != StatCounters{}) {
+        Differences.emplace_back(Id, Difference);
+      }
+    }
+    for (const auto &[Id, Counters] : PerAccount) {
+      if (!Fresh.contains(Id)) {
+        StatCounters Difference;
+        Difference -= Counters;
+        Differences.emplace_back(Id, Difference);
+      }
+    }
+
+    // A write can commit before the query and be applied after it, or the
+    // other way round, so a difference seen once may just be a write in
+    // flight. Only a difference that is still exactly the same a round
+    // later is drift; the first load takes the query as it is.
+    bool First = !ReconciledAt;
+    std::unordered_map<core::Uuid, Unsettled> StillUnsettled;
+    StatCounters Corrected;
+    size_t CorrectedAccounts = 0;
+    uint32_t LongestUnsettled = 0;
+    for (const auto &[Id, Difference] : Differences) {
+      auto Previous = Pending.find(Id);
+      if (First ||
+          (Previous != Pending.end() && Previous->second.Difference ==
+                                            Difference)) {
+        adjust(Id, Difference, true);
+        Corrected += Difference;
+        ++CorrectedAccounts;
+        continue;
+      }
+      uint32_t Rounds =
+          Previous == Pending.end() ? 1 : Previous->second.Rounds + 1;
+      LongestUnsettled = std::max(LongestUnsettled, Rounds);
+      StillUnsettled.emplace(Id, Unsettled{Difference, Rounds});
+    }
+    Pending = std::move(StillUnsettled);
+
+    if (!First && CorrectedAccounts > 0) {
+      spdlog::warn(
+          "StatsStore::reconcile - Counters of {} accounts drifted from the "
+          "database (stars {:+}, repositories {:+}), corrected",
+          CorrectedAccounts,
+          Corrected.Stars,
+          Corrected.Repositories
+      );
+    }
+    if (LongestUnsettled >= WarnUnsettledRounds) {
+      spdlog::warn(
+          "StatsStore::reconcile - {} accounts still differ from the database, "
+          "one of them for {} rounds in a row; keeping their incremental "
+          "counters",
+          Pending.size(),
+          LongestUnsettled
+      );
+    } else if (!Pending.empty()) {
+      spdlog::debug(
+          "StatsStore::reconcile - {} accounts differ from the database, "
+          "checking again next round",
+          Pending.size()
+      );
+    }
+    ReconciledAt = core::formatTimestamp(std::chrono::system_clock::now());
+  }
+
+  void adjust(const core::Uuid &Account, const StatCounters &Delta, bool Add) {
+    if (Delta == StatCounters{}) {
+      return;
+    }
+    auto &Counters = PerAccount[Account];
+    if (Add) {
+      Counters += Delta;
+      Totals += Delta;
+    } else {
+      Counters -= Delta;
+      Totals -= Delta;
+    }
+    if (Counters == StatCounters{}) {
+      PerAccount.erase(Account);
+    }
+  }
+
+  // Per-account sums of live accounts and live repositories. The two sides
+  // are aggregated separately and joined, so repositories still count
+  // towards an account that was deleted, exactly as the deltas do.
+  static std::expected<AccountCounters, core::Error>
+  query(db::Database &Database) {
+    return Database.read(
+        "StatsStore::query",
+        [](pqxx::read_transaction &Tx) {
+          static const std::string Query = std::format(
+              "SELECT COALESCE(a.id, r.account_id), "
+              "COALESCE(a.accounts, 0), COALESCE(r.repositories, 0), "
+              "COALESCE(r.stars, 0), COALESCE(r.forks, 0), "
+              "COALESCE(r.views, 0), COALESCE(r.clones, 0), "
+              "COALESCE(a.followers, 0) "
+              "FROM (SELECT id, 1 AS accounts, followers FROM {} "
+              "WHERE deleted_at IS NULL) a "
+              "FULL OUTER JOIN (SELECT account_id, COUNT(*) AS repositories, "
+              "SUM(stars) AS stars, SUM(forks) AS forks, "
+              "SUM(views) AS views, SUM(clones) AS clones FROM {} "
+              "WHERE deleted_at IS NULL GROUP BY account_id) r "
+              "ON r.account_id = a.id",
+              core::DbTraits<models::Account>::TableName,
+              core::DbTraits<models::Repository>::TableName
+          );
+          AccountCounters PerAccount;
+          for (const auto &Row : Tx.exec(pqxx::zview{Query})) {
+            PerAccount.emplace(
+                Row[0].as<core::Uuid>(),
+                StatCounters{
+                    .Accounts = Row[1].as<int64_t>(),
+                    .Repositories = Row[2].as<int64_t>(),
+                    .Stars = Row[3].as<int64_t>(),
+                    .Forks = Row[4].as<int64_t>(),
+                    .Views = Row[5].as<int64_t>(),
+                    .Clones = Row[6].as<int64_t>(),
+                    .Followers = Row[7].as<int64_t>(),
+                }
+            );
+          }
+          return PerAccount;
+        }
+    );
+  }
+};
+
+} // namespace insights::github
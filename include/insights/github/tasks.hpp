@@ -3,9 +3,11 @@
 #include "insights/core/config.hpp"
 #include "insights/github/models.hpp"
 #include "insights/core/result.hpp"
+#include "insights/core/uuid.hpp"
 #include "insights/db/db.hpp"
 
 #include <expected>
+#include <functional>
 #include <string_view>
 
 namespace insights::github::tasks {
@@ -24,26 +26,38 @@ struct SyncRunStats {
   }
 };
 
+// Callbacks invoked after the sync commits an entity update, so in-memory
+// read state (e.g. the response cache) can be refreshed. Unset hooks are
+// skipped.
+struct SyncHooks {
+  std::function<void(const models::Repository &)> OnRepositoryCommitted;
+  std::function<void(const models::Account &)> OnAccountCommitted;
+};
+
 static std::expected<std::shared_ptr<glz::http_client>, core::Error>
 createClient(const core::Config &Config);
 // Individual task functions for each entity type
 auto updateRepositories(
     std::shared_ptr<glz::http_client> Client,
     db::Database &Database,
-    const core::Config &Config
+    const core::Config &Config,
+    const SyncHooks &Hooks = {}
 ) -> std::expected<SyncEntityStats, core::Error>;
 auto updateAccounts(
     std::shared_ptr<glz::http_client> Client,
     db::Database &Database,
-    const core::Config &Config
+    const core::Config &Config,
+    const SyncHooks &Hooks = {}
 ) -> std::expected<SyncEntityStats, core::Error>;
 
 auto syncRepositoryById(
-    std::string_view RepositoryId,
+    const core::Uuid &RepositoryId,
     db::Database &Database,
-    const core::Config &Config
+    const core::Config &Config,
+    const SyncHooks &Hooks = {}
 ) -> std::expected<github::models::Repository, core::Error>;
 
 // Orchestrator that runs the full pipeline: Repos → Accounts
-auto syncStats(const core::Config &Config) -> std::expected<void, core::Error>;
+auto syncStats(const core::Config &Config, const SyncHooks &Hooks = {})
+    -> std::expected<void, core::Error>;
 } // namespace insights::github::tasks
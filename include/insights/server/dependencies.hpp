@@ -1,22 +1,25 @@
 #pragma once
+#include "insights/core/result.hpp"
+#include "insights/core/uuid.hpp"
 
 #include "glaze/net/http_router.hpp"
 
-#include <regex>
+#include <expected>
+#include <format>
 #include <string>
-#include <string_view>
 
 namespace insights::server::dependencies {
-inline glz::param_constraint uuidConstraint() {
-  glz::param_constraint Uuid{
-      .description = "Must be a valid UUID",
-      .validation = [](std::string_view Value) {
-        std::regex UuidRegex(
-            R"([0-9a-f]{8}-[0-9a-f]{4}-[0-9a-f]{4}-[0-9a-f]{4}-[0-9a-f]{12})"
-        );
-        return std::regex_match(std::string(Value), UuidRegex);
-      }
-  };
-  return Uuid;
+// The value of a UUID route parameter. The routes take any text there and
+// answer 400 on an error, rather than guarding the parameter with a router
+// constraint, which would turn a malformed id into a 404.
+inline std::expected<core::Uuid, core::Error>
+uuidParam(const glz::request &Request, const std::string &Name = "id") {
+  auto Id = core::Uuid::parse(Request.params.at(Name));
+  if (!Id) {
+    return std::unexpected(core::Error{std::format(
+        "Parameter '{}' is not a UUID: {}", Name, Id.error().Message
+    )});
+  }
+  return *Id;
 }
 } // namespace insights::server::dependencies
@@ -0,0 +1,210 @@
+#pragma once
+#include "insights/core/http.hpp"
+#include "insights/core/json.hpp"
+#include "insights/core/log_throttle.hpp"
+
+#include "glaze/net/http.hpp"
+#include "glaze/net/http_server.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <array>
+#include <asio/steady_timer.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <system_error>
+
+namespace insights::server::middleware {
+
+// Requests are counted per class, and a few expensive calls (GitHub sync,
+// batches) cannot take every thread. Exempt routes (/health, /ready,
+// /metrics) are never shed.
+enum class RouteClass : uint8_t {
+  Exempt,
+  Read,
+  Write,
+  Expensive,
+};
+
+inline constexpr std::size_t RouteClassCount = 4;
+
+// Handlers run synchronously on the server threads, so the requests in
+// flight can never outnumber the threads; a cap only binds below that.
+// Reads and writes are therefore admitted on queue delay alone, and only
+// expensive requests, which hold a thread for seconds, have their own cap.
+struct AdmissionLimits {
+  std::size_t MaxExpensive{4};
+  // Shed new work while the io_context is this far behind its timers.
+  std::chrono::milliseconds MaxQueueDelay{250};
+};
+
+struct AdmissionStats {
+  std::array<std::size_t, RouteClassCount> InFlight{};
+  std::array<uint64_t, RouteClassCount> Admitted{};
+  std::array<uint64_t, RouteClassCount> Shed{};
+  std::chrono::microseconds QueueDelay{0};
+};
+
+// Tracks in-flight requests per route class and the io_context queue delay,
+// and decides whether a new request may run. All state is atomic; the
+// middleware calls it from every server thread.
+//
+// Queue delay is measured by startQueueDelayProbe: a timer that should fire
+// every few milliseconds, whose lateness is how long a freshly queued
+// completion handler currently waits for a thread.
+struct AdmissionController {
+  explicit AdmissionController(AdmissionLimits Limits = {}) : Limits(Limits) {}
+
+  static RouteClass classify(const glz::request &Request) {
+    std::string_view Path = Request.path;
+    if (Path == "/health" || Path == "/ready" || Path == "/metrics") {
+      return RouteClass::Exempt;
+    }
+    if (Path == "/batch" || Path.ends_with("/sync") ||
+        Path.ends_with(":bulk")) {
+      return RouteClass::Expensive;
+    }
+    return Request.method == glz::http_method::GET ? RouteClass::Read
+                                                   : RouteClass::Write;
+  }
+
+  bool tryAdmit(RouteClass Class) {
+    auto Index = static_cast<std::size_t>(Class);
+    if (Class == RouteClass::Exempt) {
+      InFlight[Index].fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+    if (queueDelay() > Limits.MaxQueueDelay) {
+      Shed[Index].fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    auto Previous = InFlight[Index].fetch_add(1, std::memory_order_acq_rel);
+    if (Previous >= limit(Class)) {
+      InFlight[Index].fetch_sub(1, std::memory_order_acq_rel);
+      Shed[Index].fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    Admitted[Index].fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  void release(RouteClass Class) {
+    InFlight[static_cast<std::size_t>(Class)].fetch_sub(
+        1, std::memory_order_acq_rel
+    );
+  }
+
+  void recordQueueDelay(std::chrono::microseconds Delay) {
+    QueueDelayUs.store(Delay.count(), std::memory_order_relaxed);
+  }
+
+  std::chrono::microseconds queueDelay() const {
+    return std::chrono::microseconds{
+        QueueDelayUs.load(std::memory_order_relaxed)
+    };
+  }
+
+  // Seconds a shed client should wait: the current backlog, at least 1.
+  std::chrono::seconds retryAfter() const {
+    auto Delay = std::chrono::ceil<std::chrono::seconds>(queueDelay());
+    return std::max(Delay, std::chrono::seconds{1});
+  }
+
+  AdmissionStats stats() const {
+    AdmissionStats Stats{.QueueDelay = queueDelay()};
+    for (std::size_t I = 0; I < RouteClassCount; ++I) {
+      Stats.InFlight[I] = InFlight[I].load(std::memory_order_relaxed);
+      Stats.Admitted[I] = Admitted[I].load(std::memory_order_relaxed);
+      Stats.Shed[I] = Shed[I].load(std::memory_order_relaxed);
+    }
+    return Stats;
+  }
+
+private:
+  std::size_t limit(RouteClass Class) const {
+    return Class == RouteClass::Expensive ? Limits.MaxExpensive : SIZE_MAX;
+  }
+
+  AdmissionLimits Limits;
+  std::array<std::atomic<std::size_t>, RouteClassCount> InFlight{};
+  std::array<std::atomic<uint64_t>, RouteClassCount> Admitted{};
+  std::array<std::atomic<uint64_t>, RouteClassCount> Shed{};
+  std::atomic<int64_t> QueueDelayUs{0};
+};
+
+// Re-arms Timer every Interval and records how late each firing was.
+inline void startQueueDelayProbe(
+    std::shared_ptr<asio::steady_timer> Timer,
+    std::shared_ptr<AdmissionController> Controller,
+    std::chrono::milliseconds Interval = std::chrono::milliseconds{20}
+) {
+  auto Handler =
+      std::make_shared<std::function<void(const std::error_code &)>>();
+
+  *Handler = [Handler, Timer, Controller, Interval](const std::error_code &Ec) {
+    if (Ec) {
+      return;
+    }
+    auto Late = std::chrono::steady_clock::now() - Timer->expiry();
+    Controller->recordQueueDelay(
+        std::chrono::duration_cast<std::chrono::microseconds>(Late)
+    );
+    Timer->expires_after(Interval);
+    Timer->async_wait(*Handler);
+  };
+
+  Timer->expires_after(Interval);
+  Timer->async_wait(*Handler);
+}
+
+// Rejects requests with 503 and Retry-After when the server is already
+// queueing work or an expensive request would exceed its cap, so admitted
+// requests keep a bounded latency instead of everyone timing out together.
+// Shedding happens exactly when the server is saturated, so it is counted
+// in the controller's stats and logged at most once per interval rather
+// than adding a synchronous log write to every rejected request.
+inline auto
+createAdmissionMiddleware(std::shared_ptr<AdmissionController> Controller) {
+  auto Throttle = std::make_shared<core::LogThrottle>();
+  return [Controller, Throttle](
+             const glz::request &Request,
+             glz::response &Response,
+             const auto &Next
+         ) {
+    auto Class = AdmissionController::classify(Request);
+    if (!Controller->tryAdmit(Class)) {
+      auto RetryAfter = Controller->retryAfter();
+      if (auto Count = Throttle->record(); Count != 0) {
+        spdlog::warn(
+            "{} request(s) shed since the last report: server overloaded "
+            "(queue delay {}us); latest [{}] {}",
+            Count,
+            Controller->queueDelay().count(),
+            glz::to_string(Request.method),
+            Request.path
+        );
+      }
+      core::respondError(
+          Response, core::HttpStatus::ServiceUnavailable, "Server overloaded"
+      );
+      Response.header("Retry-After", std::format("{}", RetryAfter.count()));
+      return;
+    }
+
+    struct Release {
+      AdmissionController &Controller;
+      RouteClass Class;
+      ~Release() { Controller.release(Class); }
+    } Guard{*Controller, Class};
+    Next();
+  };
+}
+
+} // namespace insights::server::middleware
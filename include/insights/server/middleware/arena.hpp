@@ -0,0 +1,19 @@
+#pragma once
+#include "insights/core/arena.hpp"
+
+#include "glaze/net/http.hpp"
+#include "glaze/net/http_server.hpp"
+
+namespace insights::server::middleware {
+
+// Gives the handler a request-scoped arena (core::requestResource()) and
+// frees it when the response is done. Handlers run synchronously inside
+// Next() on this thread, so the thread-local arena is theirs alone.
+inline auto createArenaMiddleware() {
+  return [](const glz::request &, glz::response &, const auto &Next) {
+    core::RequestArena Arena;
+    Next();
+  };
+}
+
+} // namespace insights::server::middleware
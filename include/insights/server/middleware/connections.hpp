@@ -0,0 +1,364 @@
+#pragma once
+#include "insights/core/contention.hpp"
+#include "insights/core/http.hpp"
+#include "insights/core/json.hpp"
+#include "insights/core/log_throttle.hpp"
+#include "insights/core/negotiation.hpp"
+#include "insights/server/middleware/admission.hpp"
+
+#include "glaze/net/http.hpp"
+#include "glaze/net/http_server.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <array>
+#include <asio/steady_timer.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+
+namespace insights::server::middleware {
+
+// Zero disables a limit.
+struct ConnectionLimits {
+  std::size_t MaxConnections{4096};
+  std::chrono::seconds IdleTimeout{60};
+  uint32_t MaxRequestsPerConnection{1000};
+  // Once MaxConnections is reached, connections silent for this long are
+  // presumed closed by the client and stop counting towards it.
+  std::chrono::seconds ReclaimAfter{5};
+};
+
+enum class ConnectionVerdict : uint8_t { Keep, Close, Reject };
+
+struct ConnectionStats {
+  std::size_t Open{0};
+  std::size_t Idle{0};
+  uint64_t Rejected{0};
+  uint64_t ClosedIdle{0};
+  uint64_t ClosedMaxRequests{0};
+  uint64_t Reclaimed{0};
+};
+
+// Remote address and port of a connection, copied into a fixed-size key so
+// tracking a request allocates nothing.
+struct ConnectionKey {
+  // Long enough for any textual IPv6 address.
+  std::array<char, 46> Address{};
+  uint8_t Length{0};
+  uint16_t Port{0};
+
+  ConnectionKey() = default;
+  ConnectionKey(std::string_view Ip, uint16_t Port)
+      : Length(static_cast<uint8_t>(std::min(Ip.size(), Address.size()))),
+        Port(Port) {
+    std::copy_n(Ip.begin(), Length, Address.begin());
+  }
+
+  std::string_view address() const { return {Address.data(), Length}; }
+
+  bool operator==(const ConnectionKey &Other) const {
+    return Port == Other.Port && address() == Other.address();
+  }
+};
+
+struct ConnectionKeyHash {
+  std::size_t operator()(const ConnectionKey &Key) const {
+    return std::hash<std::string_view>{}(Key.address()) ^
+           (static_cast<std::size_t>(Key.Port) * 0x9e3779b97f4a7c15ULL);
+  }
+};
+
+// Tracks keep-alive connections by remote address and port and applies
+// the lifecycle limits at the first request where they can be enforced.
+//
+// glaze owns the sockets and exposes no handle to them, so a connection is
+// only seen through its requests and the server closes it by answering
+// with "Connection: close", which HTTP/1.1 clients must honour. Every other
+// response advertises IdleTimeout in "Keep-Alive: timeout=N", after which
+// clients drop the connection themselves. Consequently:
+//  - a connection that is over MaxRequestsPerConnection is closed after
+//    its last allowed response;
+//  - one that was silent for IdleTimeout moves from Open to Idle at the
+//    next sweep and stops counting towards MaxConnections, since the client
+//    was told to close it by then; if it sends another request anyway, it
+//    is closed and only then counted in ClosedIdle;
+//  - a request that says "Connection: close" releases its connection's
+//    slot (or never takes one), since the client closes it after the
+//    response;
+//  - a new connection beyond MaxConnections is refused with 503, after
+//    first reclaiming connections silent for ReclaimAfter.
+// Other client-side closes (an HTTP/1.0 client without keep-alive, or a
+// client that just hangs up; glaze does not report the request's version)
+// are not observed. They hold a slot until they go idle, or until the cap
+// is reached and they are reclaimed, so Open is an upper bound.
+struct ConnectionTracker {
+  explicit ConnectionTracker(ConnectionLimits Limits = {}) : Limits(Limits) {}
+
+  // Closing is set when the request asked for "Connection: close".
+  ConnectionVerdict
+  onRequest(const ConnectionKey &Key, bool Exempt, bool Closing = false) {
+    auto Now = nowNs();
+    auto &Shard = Shards[ConnectionKeyHash{}(Key) % ShardCount];
+    std::unique_lock Lock(Shard.Mutex);
+    auto It = Shard.Connections.find(Key);
+    if (It == Shard.Connections.end()) {
+      if (Closing) {
+        return ConnectionVerdict::Close;
+      }
+      if (!Exempt && overCap()) {
+        // reclaim() takes every shard lock in turn.
+        Lock.unlock();
+        reclaim(Now);
+        Lock.lock();
+        It = Shard.Connections.find(Key);
+      }
+    }
+    if (It == Shard.Connections.end()) {
+      if (!Exempt && overCap()) {
+        Rejected.fetch_add(1, std::memory_order_relaxed);
+        return ConnectionVerdict::Reject;
+      }
+      It = Shard.Connections.try_emplace(Key).first;
+      Open.fetch_add(1, std::memory_order_relaxed);
+    } else if (It->second.Idle) {
+      Shard.Connections.erase(It);
+      Idle.fetch_sub(1, std::memory_order_relaxed);
+      ClosedIdle.fetch_add(1, std::memory_order_relaxed);
+      return ConnectionVerdict::Close;
+    }
+
+    if (Closing) {
+      Shard.Connections.erase(It);
+      Open.fetch_sub(1, std::memory_order_relaxed);
+      return ConnectionVerdict::Close;
+    }
+
+    auto &Entry = It->second;
+    Entry.LastSeen = Now;
+    ++Entry.Requests;
+    if (Limits.MaxRequestsPerConnection != 0 &&
+        Entry.Requests >= Limits.MaxRequestsPerConnection) {
+      Shard.Connections.erase(It);
+      Open.fetch_sub(1, std::memory_order_relaxed);
+      ClosedMaxRequests.fetch_add(1, std::memory_order_relaxed);
+      return ConnectionVerdict::Close;
+    }
+    return ConnectionVerdict::Keep;
+  }
+
+  // Moves connections silent for IdleTimeout from Open to Idle; idle
+  // entries that never came back are forgotten after ten more timeouts
+  // (the client has long since closed them).
+  void sweep() {
+    if (Limits.IdleTimeout.count() == 0) {
+      return;
+    }
+    auto Timeout =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Limits.IdleTimeout)
+            .count();
+    auto Now = nowNs();
+    for (auto &Shard : Shards) {
+      std::scoped_lock Lock(Shard.Mutex);
+      for (auto It = Shard.Connections.begin();
+           It != Shard.Connections.end();) {
+        auto &Entry = It->second;
+        if (!Entry.Idle && Now - Entry.LastSeen > Timeout) {
+          markIdle(Entry);
+        }
+        if (Entry.Idle && Now - Entry.LastSeen > 11 * Timeout) {
+          It = Shard.Connections.erase(It);
+          Idle.fetch_sub(1, std::memory_order_relaxed);
+        } else {
+          ++It;
+        }
+      }
+    }
+  }
+
+  ConnectionStats stats() const {
+    return {
+        .Open = Open.load(std::memory_order_relaxed),
+        .Idle = Idle.load(std::memory_order_relaxed),
+        .Rejected = Rejected.load(std::memory_order_relaxed),
+        .ClosedIdle = ClosedIdle.load(std::memory_order_relaxed),
+        .ClosedMaxRequests = ClosedMaxRequests.load(std::memory_order_relaxed),
+        .Reclaimed = Reclaimed.load(std::memory_order_relaxed),
+    };
+  }
+
+  const ConnectionLimits &limits() const { return Limits; }
+
+private:
+  static constexpr std::size_t ShardCount = 64;
+
+  struct Entry {
+    uint32_t Requests{0};
+    int64_t LastSeen{0};
+    bool Idle{false};
+  };
+
+  struct LockTag {
+    static constexpr std::string_view Name = "connections";
+  };
+
+  struct Shard {
+    core::CountedMutex<std::mutex, LockTag> Mutex;
+    std::unordered_map<ConnectionKey, Entry, ConnectionKeyHash> Connections;
+  };
+
+  static int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()
+    )
+        .count();
+  }
+
+  bool overCap() const {
+    return Limits.MaxConnections != 0 &&
+           Open.load(std::memory_order_relaxed) >= Limits.MaxConnections;
+  }
+
+  void markIdle(Entry &Connection) {
+    Connection.Idle = true;
+    Open.fetch_sub(1, std::memory_order_relaxed);
+    Idle.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Moves connections silent for ReclaimAfter from Open to Idle, so
+  // connections the client closed unobserved do not lock new ones out
+  // until the sweep. Runs at most once per ReclaimAfter / 4 however many
+  // requests arrive at the cap; the others just see the result.
+  void reclaim(int64_t Now) {
+    auto After =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Limits.ReclaimAfter
+        )
+            .count();
+    auto Due = NextReclaim.load(std::memory_order_relaxed);
+    if (Now < Due || !NextReclaim.compare_exchange_strong(
+                         Due, Now + After / 4, std::memory_order_relaxed
+                     )) {
+      return;
+    }
+    for (auto &Shard : Shards) {
+      std::scoped_lock Lock(Shard.Mutex);
+      for (auto &[Key, Connection] : Shard.Connections) {
+        if (!Connection.Idle && Now - Connection.LastSeen > After) {
+          markIdle(Connection);
+          Reclaimed.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    }
+  }
+
+  ConnectionLimits Limits;
+  std::array<Shard, ShardCount> Shards;
+  std::atomic<std::size_t> Open{0};
+  std::atomic<std::size_t> Idle{0};
+  std::atomic<uint64_t> Rejected{0};
+  std::atomic<uint64_t> ClosedIdle{0};
+  std::atomic<uint64_t> ClosedMaxRequests{0};
+  std::atomic<uint64_t> Reclaimed{0};
+  std::atomic<int64_t> NextReclaim{0};
+};
+
+// True when the request asks for its connection to be closed after the
+// response.
+inline bool clientCloses(const glz::request &Request) {
+  auto Value = core::findHeader(Request, "Connection");
+  return Value && core::equalsIgnoreCase(core::trim(*Value), "close");
+}
+
+inline ConnectionKey connectionKey(const glz::request &Request) {
+  return {Request.remote_ip, Request.remote_port};
+}
+
+// Runs Tracker.sweep() on Timer's io_context, four times per idle timeout.
+inline void startConnectionSweep(
+    std::shared_ptr<asio::steady_timer> Timer,
+    std::shared_ptr<ConnectionTracker> Tracker
+) {
+  auto Interval = std::max(
+      Tracker->limits().IdleTimeout / 4, std::chrono::seconds{1}
+  );
+  auto Handler =
+      std::make_shared<std::function<void(const std::error_code &)>>();
+
+  *Handler = [Handler, Timer, Tracker, Interval](const std::error_code &Ec) {
+    if (Ec) {
+      return;
+    }
+    Tracker->sweep();
+    Timer->expires_after(Interval);
+    Timer->async_wait(*Handler);
+  };
+
+  Timer->expires_after(Interval);
+  Timer->async_wait(*Handler);
+}
+
+// Applies the ConnectionTracker verdict: refuses connections over the cap
+// with 503, asks the client to close connections that reached a limit and
+// advertises the idle timeout on the rest. /health, /ready and /metrics
+// are never refused, so probes still get through. Refusals are counted in
+// the tracker's stats and logged at most once per interval.
+inline auto
+createConnectionMiddleware(std::shared_ptr<ConnectionTracker> Tracker) {
+  auto IdleTimeout = Tracker->limits().IdleTimeout;
+  auto KeepAlive = IdleTimeout.count() == 0
+                       ? std::string{}
+                       : std::format("timeout={}", IdleTimeout.count());
+  auto Throttle = std::make_shared<core::LogThrottle>();
+  return [Tracker, KeepAlive = std::move(KeepAlive), Throttle](
+             const glz::request &Request,
+             glz::response &Response,
+             const auto &Next
+         ) {
+    auto Exempt =
+        AdmissionController::classify(Request) == RouteClass::Exempt;
+    switch (Tracker->onRequest(
+        connectionKey(Request), Exempt, clientCloses(Request)
+    )) {
+    case ConnectionVerdict::Reject:
+      if (auto Count = Throttle->record(); Count != 0) {
+        spdlog::warn(
+            "{} connection(s) refused since the last report: connection "
+            "limit reached; latest [{}] {}",
+            Count,
+            glz::to_string(Request.method),
+            Request.path
+        );
+      }
+      core::respondError(
+          Response, core::HttpStatus::ServiceUnavailable, "Too many connections"
+      );
+      Response.header("Retry-After", "1");
+      Response.header("Connection", "close");
+      return;
+    case ConnectionVerdict::Close:
+      Next();
+      Response.header("Connection", "close");
+      return;
+    case ConnectionVerdict::Keep:
+      Next();
+      if (!KeepAlive.empty()) {
+        Response.header("Keep-Alive", KeepAlive);
+      }
+      return;
+    }
+  };
+}
+
+} // namespace insights::server::middleware
@@ -1,26 +1,34 @@
 #pragma once
+#include "insights/core/access_log.hpp"
+#include "insights/core/metrics.hpp"
+
 #include "glaze/net/http.hpp"
 #include "glaze/net/http_server.hpp"
 
-#include "spdlog/spdlog.h"
+#include <chrono>
+#include <memory>
 
 namespace insights::server::middleware {
 
-inline auto createLoggingMiddleware() {
-  return [](const glz::request &Request,
-            glz::response &Response,
-            const auto &Next) {
+// Records every request's latency into Metrics (served by GET /metrics) and
+// hands it to the asynchronous AccessLog, which samples and writes it off
+// the request path.
+inline auto createLoggingMiddleware(
+    std::shared_ptr<core::Metrics> Metrics,
+    std::shared_ptr<core::AccessLog> AccessLog
+) {
+  return [Metrics, AccessLog](const glz::request &Request,
+                              glz::response &Response,
+                              const auto &Next) {
     auto Start = std::chrono::steady_clock::now();
     // Handler Execution
     Next();
     auto Duration = std::chrono::steady_clock::now() - Start;
-    // Log with status
-    spdlog::info(
-        "[{}] {} {} {}ms",
-        glz::to_string(Request.method),
-        Request.path,
-        Response.status_code,
-        std::chrono::duration_cast<std::chrono::milliseconds>(Duration).count()
+    Metrics->observe(
+        Request.method, Request.path, Response.status_code, Duration
+    );
+    AccessLog->record(
+        Request.method, Request.path, Response.status_code, Duration
     );
   };
 }
@@ -0,0 +1,329 @@
+#pragma once
+#include "insights/core/contention.hpp"
+#include "insights/core/http.hpp"
+#include "insights/core/json.hpp"
+#include "insights/core/log_throttle.hpp"
+#include "insights/core/negotiation.hpp"
+#include "insights/server/middleware/admission.hpp"
+
+#include "glaze/net/http.hpp"
+#include "glaze/net/http_server.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <array>
+#include <asio/steady_timer.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+
+namespace insights::server::middleware {
+
+// Requests a client may burst, and the rate they refill at. A zero burst
+// or rate leaves the class unlimited.
+struct RatePolicy {
+  uint32_t Burst{0};
+  double PerSecond{0.0};
+};
+
+// Per route class (see RouteClass); Exempt routes are never limited.
+struct RateLimits {
+  RatePolicy Read{.Burst = 120, .PerSecond = 20.0};
+  RatePolicy Write{.Burst = 30, .PerSecond = 5.0};
+  RatePolicy Expensive{.Burst = 5, .PerSecond = 0.2};
+  // Clients idle this long are evicted from the table.
+  std::chrono::seconds IdleTtl{600};
+  // Bound on tracked clients. Once a shard is full, new clients share that
+  // shard's overflow bucket until eviction makes room.
+  std::size_t MaxClients{100'000};
+};
+
+struct RateDecision {
+  bool Allowed{true};
+  uint32_t Limit{0};
+  uint32_t Remaining{0};
+  // Seconds until the bucket is full again (RateLimit-Reset), or until the
+  // next request would be allowed when rejected (Retry-After).
+  int64_t ResetSeconds{0};
+};
+
+struct RateLimiterStats {
+  std::size_t Clients{0};
+  uint64_t Limited{0};
+  uint64_t Evicted{0};
+  uint64_t Overflowed{0};
+};
+
+// Per-client token buckets, sharded by client key.
+//
+// Each bucket is stored as a single "theoretical arrival time" (the GCRA
+// form of a token bucket): a request is allowed if that time is no more
+// than Burst emission intervals ahead of now, and pushes it forward by one
+// interval. That makes the check one atomic compare-exchange, so the hot
+// path only takes its shard's lock in shared mode to find the client; the
+// exclusive lock is for the first request of a new client and eviction.
+// The table is capped at Limits.MaxClients.
+struct RateLimiter {
+  explicit RateLimiter(RateLimits Limits = {}) : Limits(Limits) {}
+
+  RateDecision admit(std::string_view Client, RouteClass Class) {
+    const auto *Policy = policy(Class);
+    if (Policy == nullptr || Policy->Burst == 0 || Policy->PerSecond <= 0.0) {
+      return {};
+    }
+    auto Now = nowNs();
+    auto &Bucket = bucketFor(Client, Now)
+                       .Tat[static_cast<std::size_t>(Class)];
+
+    auto Interval = static_cast<int64_t>(1e9 / Policy->PerSecond);
+    auto Tolerance = Interval * static_cast<int64_t>(Policy->Burst);
+    auto Tat = Bucket.load(std::memory_order_relaxed);
+    while (true) {
+      auto Base = std::max(Tat, Now);
+      auto Next = Base + Interval;
+      if (Next - Now > Tolerance) {
+        Limited.fetch_add(1, std::memory_order_relaxed);
+        return {
+            .Allowed = false,
+            .Limit = Policy->Burst,
+            .Remaining = 0,
+            .ResetSeconds = ceilSeconds(Next - Now - Tolerance),
+        };
+      }
+      if (Bucket.compare_exchange_weak(
+              Tat, Next, std::memory_order_relaxed, std::memory_order_relaxed
+          )) {
+        return {
+            .Allowed = true,
+            .Limit = Policy->Burst,
+            .Remaining =
+                static_cast<uint32_t>((Tolerance - (Next - Now)) / Interval),
+            .ResetSeconds = ceilSeconds(Next - Now),
+        };
+      }
+    }
+  }
+
+  // Drops clients that have not been seen for IdleTtl. Their buckets are
+  // full again by then, so forgetting them changes no decision.
+  void evictIdle() {
+    auto Cutoff =
+        nowNs() -
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Limits.IdleTtl)
+            .count();
+    for (auto &Shard : Shards) {
+      std::unique_lock Lock(Shard.Mutex);
+      Evicted.fetch_add(
+          std::erase_if(
+              Shard.Clients,
+              [Cutoff](const auto &Entry) {
+                return Entry.second->LastSeen.load(std::memory_order_relaxed) <
+                       Cutoff;
+              }
+          ),
+          std::memory_order_relaxed
+      );
+    }
+  }
+
+  RateLimiterStats stats() const {
+    RateLimiterStats Stats{
+        .Limited = Limited.load(std::memory_order_relaxed),
+        .Evicted = Evicted.load(std::memory_order_relaxed),
+        .Overflowed = Overflowed.load(std::memory_order_relaxed),
+    };
+    for (const auto &Shard : Shards) {
+      std::shared_lock Lock(Shard.Mutex);
+      Stats.Clients += Shard.Clients.size();
+    }
+    return Stats;
+  }
+
+private:
+  static constexpr std::size_t ShardCount = 64;
+
+  struct Bucket {
+    std::array<std::atomic<int64_t>, RouteClassCount> Tat{};
+    std::atomic<int64_t> LastSeen{0};
+  };
+
+  struct KeyHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view Key) const {
+      return std::hash<std::string_view>{}(Key);
+    }
+  };
+
+  struct LockTag {
+    static constexpr std::string_view Name = "rate_limit";
+  };
+
+  struct Shard {
+    mutable core::CountedMutex<std::shared_mutex, LockTag> Mutex;
+    std::unordered_map<
+        std::string,
+        std::unique_ptr<Bucket>,
+        KeyHash,
+        std::equal_to<>>
+        Clients;
+    // Shared by the clients that arrive while the shard is full.
+    Bucket Overflow;
+  };
+
+  static int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()
+    )
+        .count();
+  }
+
+  static int64_t ceilSeconds(int64_t Ns) {
+    return (Ns + 999'999'999) / 1'000'000'000;
+  }
+
+  const RatePolicy *policy(RouteClass Class) const {
+    switch (Class) {
+    case RouteClass::Read:
+      return &Limits.Read;
+    case RouteClass::Write:
+      return &Limits.Write;
+    case RouteClass::Expensive:
+      return &Limits.Expensive;
+    case RouteClass::Exempt:
+      break;
+    }
+    return nullptr;
+  }
+
+  // Buckets are heap-allocated so their address survives rehashing; only
+  // eviction (exclusive lock) frees them.
+  Bucket &bucketFor(std::string_view Client, int64_t Now) {
+    auto &Shard = Shards[KeyHash{}(Client) % ShardCount];
+    {
+      std::shared_lock Lock(Shard.Mutex);
+      if (auto It = Shard.Clients.find(Client); It != Shard.Clients.end()) {
+        touch(*It->second, Now);
+        return *It->second;
+      }
+    }
+    std::unique_lock Lock(Shard.Mutex);
+    if (auto It = Shard.Clients.find(Client); It != Shard.Clients.end()) {
+      touch(*It->second, Now);
+      return *It->second;
+    }
+    auto PerShard = std::max<std::size_t>(Limits.MaxClients / ShardCount, 1);
+    if (Shard.Clients.size() >= PerShard) {
+      Overflowed.fetch_add(1, std::memory_order_relaxed);
+      return Shard.Overflow;
+    }
+    auto &Entry = *Shard.Clients
+                       .emplace(std::string(Client), std::make_unique<Bucket>())
+                       .first->second;
+    touch(Entry, Now);
+    return Entry;
+  }
+
+  // LastSeen only drives eviction, so it is refreshed at most once a
+  // second to keep the shared cache line quiet.
+  static void touch(Bucket &Entry, int64_t Now) {
+    if (Now - Entry.LastSeen.load(std::memory_order_relaxed) > 1'000'000'000) {
+      Entry.LastSeen.store(Now, std::memory_order_relaxed);
+    }
+  }
+
+  RateLimits Limits;
+  std::array<Shard, ShardCount> Shards;
+  std::atomic<uint64_t> Limited{0};
+  std::atomic<uint64_t> Evicted{0};
+  std::atomic<uint64_t> Overflowed{0};
+};
+
+// Identifies the caller by its remote address. Client-supplied identifiers
+// such as an API key header are not used: nothing authenticates them, so a
+// client could pick a fresh one per request to get a fresh bucket.
+inline std::string_view rateLimitKey(const glz::request &Request) {
+  return Request.remote_ip;
+}
+
+// Runs Limiter.evictIdle() every Interval on Timer's io_context.
+inline void startRateLimitEviction(
+    std::shared_ptr<asio::steady_timer> Timer,
+    std::shared_ptr<RateLimiter> Limiter,
+    std::chrono::seconds Interval = std::chrono::seconds{60}
+) {
+  auto Handler =
+      std::make_shared<std::function<void(const std::error_code &)>>();
+
+  *Handler = [Handler, Timer, Limiter, Interval](const std::error_code &Ec) {
+    if (Ec) {
+      return;
+    }
+    Limiter->evictIdle();
+    Timer->expires_after(Interval);
+    Timer->async_wait(*Handler);
+  };
+
+  Timer->expires_after(Interval);
+  Timer->async_wait(*Handler);
+}
+
+// Answers 429 with Retry-After once a client has spent its burst for the
+// route class, and reports the bucket on every limited route through the
+// RateLimit-Limit / RateLimit-Remaining / RateLimit-Reset headers.
+// Rejections are counted in Limiter's stats; the log gets one summary line
+// per interval, since a client hammering past its budget would otherwise
+// turn every rejected request into a synchronous log write.
+inline auto createRateLimitMiddleware(std::shared_ptr<RateLimiter> Limiter) {
+  auto Throttle = std::make_shared<core::LogThrottle>();
+  return [Limiter, Throttle](
+             const glz::request &Request,
+             glz::response &Response,
+             const auto &Next
+         ) {
+    auto Class = AdmissionController::classify(Request);
+    auto Decision = Limiter->admit(rateLimitKey(Request), Class);
+    if (Decision.Limit == 0) {
+      Next();
+      return;
+    }
+
+    if (!Decision.Allowed) {
+      if (auto Count = Throttle->record(); Count != 0) {
+        spdlog::warn(
+            "{} request(s) rate limited since the last report; latest [{}] "
+            "{} for {}",
+            Count,
+            glz::to_string(Request.method),
+            Request.path,
+            rateLimitKey(Request)
+        );
+      }
+      core::respondError(
+          Response, core::HttpStatus::TooManyRequests, "Rate limit exceeded"
+      );
+      Response.header("Retry-After", std::format("{}", Decision.ResetSeconds));
+    } else {
+      Next();
+    }
+    Response.header("RateLimit-Limit", std::format("{}", Decision.Limit));
+    Response.header(
+        "RateLimit-Remaining", std::format("{}", Decision.Remaining)
+    );
+    Response.header(
+        "RateLimit-Reset", std::format("{}", Decision.ResetSeconds)
+    );
+  };
+}
+
+} // namespace insights::server::middleware
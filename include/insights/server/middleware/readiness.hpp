@@ -0,0 +1,49 @@
+#pragma once
+#include "insights/core/http.hpp"
+#include "insights/core/json.hpp"
+#include "insights/core/startup.hpp"
+#include "insights/server/middleware/admission.hpp"
+
+#include "glaze/net/http.hpp"
+#include "glaze/net/http_server.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <memory>
+
+namespace insights::server::middleware {
+
+// The listener accepts as soon as the process starts, before the database
+// is connected and the read state loaded. Until Startup is ready, requests
+// are answered 503 with Retry-After; probes (/health, /ready, /metrics) go
+// through so orchestrators can watch the warm-up.
+inline auto createReadinessMiddleware(std::shared_ptr<core::Startup> Startup) {
+  return [Startup](
+             const glz::request &Request,
+             glz::response &Response,
+             const auto &Next
+         ) {
+    if (!Startup->isReady()) {
+      if (AdmissionController::classify(Request) == RouteClass::Exempt) {
+        Next();
+        return;
+      }
+      core::respondError(
+          Response, core::HttpStatus::ServiceUnavailable, "Starting up"
+      );
+      Response.header("Retry-After", "1");
+      return;
+    }
+    if (auto Ms = Startup->firstRequest()) {
+      spdlog::info(
+          "First request ({} {}) served {:.1f}ms after start.",
+          glz::to_string(Request.method),
+          Request.path,
+          *Ms
+      );
+    }
+    Next();
+  };
+}
+
+} // namespace insights::server::middleware
@@ -1,22 +1,75 @@
 #pragma once
-#include "glaze/net/http_server.hpp"
+#include "insights/core/access_log.hpp"
+#include "insights/core/cache.hpp"
+#include "insights/core/config.hpp"
+#include "insights/core/metrics.hpp"
 #include "insights/core/result.hpp"
+#include "insights/core/startup.hpp"
+#include "insights/db/db.hpp"
+#include "insights/github/state.hpp"
+#include "insights/server/middleware/admission.hpp"
+#include "insights/server/middleware/connections.hpp"
+#include "insights/server/middleware/rate_limit.hpp"
+
+#include "glaze/net/http_router.hpp"
+#include "glaze/net/http_server.hpp"
 
+#include <asio/io_context.hpp>
+#include <chrono>
 #include <expected>
 #include <memory>
-#include <optional>
 
 namespace insights::server {
 
-std::expected<std::unique_ptr<glz::http_server<false>>, core::Error>
-initServer(std::string Address, int Port);
-std::expected<void, core::Error> startServer(
-    glz::http_server<false> &Server,
-    std::string Address,
-    int Port,
-    std::optional<int> Workers = std::nullopt
+// Knobs that are not part of the environment Config, for callers that embed
+// the server (the stress harness) rather than run it as a service.
+struct AppOptions {
+  middleware::AdmissionLimits AdmissionLimits{};
+  // Origin of the startup timings; main passes the time it was entered.
+  std::chrono::steady_clock::time_point Started{
+      std::chrono::steady_clock::now()
+  };
+};
+
+// Everything the server process serves: the middleware stack, the
+// database connection, the in-memory read state and the mounted routers,
+// with their background timers on IOContext. Not yet bound or started;
+// callers bind Server, start it with 0 workers and run IOContext on as many
+// threads as they like. Until warmUp() succeeds the database is not
+// connected and only the probe routes answer; the rest return 503.
+struct App {
+  explicit App(std::shared_ptr<asio::io_context> IOContext)
+      : IOContext(IOContext), Server(IOContext) {}
+
+  std::shared_ptr<asio::io_context> IOContext;
+  glz::http_server<false> Server;
+  glz::http_router Router;
+  glz::http_router GitHubRouter;
+
+  std::shared_ptr<core::Metrics> Metrics;
+  std::shared_ptr<core::AccessLog> AccessLog;
+  std::shared_ptr<middleware::ConnectionTracker> Connections;
+  std::shared_ptr<middleware::RateLimiter> RateLimiter;
+  std::shared_ptr<middleware::AdmissionController> Admission;
+  std::shared_ptr<core::Startup> Startup;
+  std::shared_ptr<db::Database> Database;
+  std::shared_ptr<github::ReadState> GitHubState;
+};
+
+// Registers middleware, routes and metrics. Touches neither the database
+// nor the network, so the listener can come up before its dependencies.
+std::expected<std::unique_ptr<App>, core::Error> createApp(
+    std::shared_ptr<asio::io_context> IOContext,
+    const core::Config &Config,
+    AppOptions Options = {}
 );
-// core::Result<void> registerRouter(const GlazeServer &Server,
-//                                   const GlazeRouter &Router,
-//                                   std::string Route);
+
+// Connects the database, then loads the entity snapshot and the aggregate
+// stats concurrently and marks the app ready. Fails, leaving the app not
+// ready, if the database or the snapshot cannot be loaded (the stats are
+// retried by their reconciliation instead). Safe to call again after a
+// failure; each step records its time in App::Startup.
+std::expected<void, core::Error>
+warmUp(App &Self, const core::Config &Config);
+
 } // namespace insights::server
@@ -83,3 +83,17 @@ CREATE TABLE github_repositories (
     deleted_at TIMESTAMPTZ,
     UNIQUE(name, account_id)
 );
+
+-- List queries (?account_id=, ?min_stars=, ?sort=) only see live rows, so
+-- their indexes are partial on deleted_at IS NULL.
+CREATE INDEX idx_github_repositories_account_id_stars
+    ON github_repositories(account_id, stars DESC, id)
+    WHERE deleted_at IS NULL;
+
+CREATE INDEX idx_github_repositories_stars
+    ON github_repositories(stars DESC, id)
+    WHERE deleted_at IS NULL;
+
+CREATE INDEX idx_github_accounts_followers
+    ON github_accounts(followers DESC, id)
+    WHERE deleted_at IS NULL;
@@ -0,0 +1,200 @@
+#include "insights/core/batch.hpp"
+
+#include "insights/core/http.hpp"
+#include "insights/core/json.hpp"
+#include "insights/core/negotiation.hpp"
+
+#include "glaze/json/read.hpp"
+#include "glaze/json/write.hpp"
+
+#include <algorithm>
+#include <format>
+#include <optional>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace insights::core {
+
+namespace {
+
+std::optional<glz::http_method> parseMethod(std::string_view Method) {
+  using enum glz::http_method;
+  if (equalsIgnoreCase(Method, "GET")) {
+    return GET;
+  }
+  if (equalsIgnoreCase(Method, "POST")) {
+    return POST;
+  }
+  if (equalsIgnoreCase(Method, "PUT")) {
+    return PUT;
+  }
+  if (equalsIgnoreCase(Method, "PATCH")) {
+    return PATCH;
+  }
+  if (equalsIgnoreCase(Method, "DELETE")) {
+    return DELETE;
+  }
+  return std::nullopt;
+}
+
+BatchResult errorResult(HttpStatus Status, std::string_view Message) {
+  auto Body = writeJson(ErrorResponse{Message});
+  return BatchResult{
+      .Status = static_cast<int>(Status),
+      .Body = glz::raw_json{Body ? std::string(*Body) : "null"},
+  };
+}
+
+// Runs one operation against the first mount whose prefix matches its
+// path. Sub-requests inherit the outer request's headers (auth, client
+// address) but always answer in JSON so they can be embedded in the batch
+// response. Middleware is not re-run per operation; the outer /batch
+// request already went through it.
+BatchResult dispatch(
+    const std::vector<BatchMount> &Mounts,
+    const glz::request &Outer,
+    const BatchOperation &Operation
+) {
+  using enum HttpStatus;
+  auto Method = parseMethod(Operation.Method);
+  if (!Method) {
+    return errorResult(
+        BadRequest, std::format("Unsupported method '{}'", Operation.Method)
+    );
+  }
+
+  std::string_view Target = Operation.Path;
+  auto Path = Target.substr(0, Target.find('?'));
+  if (!Path.starts_with('/')) {
+    return errorResult(BadRequest, "Path must start with '/'");
+  }
+  if (Path == "/batch") {
+    return errorResult(BadRequest, "Batches cannot be nested");
+  }
+
+  for (const auto &Mount : Mounts) {
+    std::string_view Prefix = Mount.Prefix;
+    if (Prefix.ends_with('/')) {
+      Prefix.remove_suffix(1);
+    }
+    if (!Path.starts_with(Prefix)) {
+      continue;
+    }
+    auto Local = Path.substr(Prefix.size());
+    if (!Local.empty() && !Local.starts_with('/')) {
+      continue;
+    }
+    std::string LocalPath = Local.empty() ? "/" : std::string(Local);
+
+    auto [Handler, Params] = Mount.Router->match(*Method, LocalPath);
+    if (!Handler) {
+      continue;
+    }
+
+    glz::request Request{};
+    Request.method = *Method;
+    Request.target = std::string(Target);
+    Request.path = LocalPath;
+    Request.params = std::move(Params);
+    Request.headers = Outer.headers;
+    std::erase_if(Request.headers, [](const auto &Header) {
+      return equalsIgnoreCase(Header.first, "accept");
+    });
+    Request.headers["accept"] = std::string(JsonMediaType);
+    Request.body = Operation.Body ? Operation.Body->str : std::string{};
+    Request.remote_ip = Outer.remote_ip;
+    Request.remote_port = Outer.remote_port;
+
+    glz::response Response{};
+    Handler(Request, Response);
+
+    auto &Body = Response.response_body;
+    BatchResult Result{.Status = Response.status_code};
+    if (Body.empty()) {
+      Result.Body = glz::raw_json{"null"};
+    } else if (!glz::validate_json(Body)) {
+      Result.Body = glz::raw_json{std::move(Body)};
+    } else {
+      // Not JSON (e.g. a plain-text error); embed it as a string.
+      std::string Quoted;
+      (void)glz::write_json(Body, Quoted);
+      Result.Body = glz::raw_json{std::move(Quoted)};
+    }
+    return Result;
+  }
+
+  return errorResult(
+      NotFound, std::format("No route for {} {}", Operation.Method, Path)
+  );
+}
+
+} // namespace
+
+void registerBatchRoute(
+    glz::http_router &Router, std::vector<BatchMount> Mounts
+) {
+  // Longest prefix first, so "/api/github" wins over "/".
+  std::ranges::sort(Mounts, [](const auto &Lhs, const auto &Rhs) {
+    return Lhs.Prefix.size() > Rhs.Prefix.size();
+  });
+
+  Router.post(
+      "/batch",
+      [Mounts = std::move(Mounts)](
+          const glz::request &Request, glz::response &Response
+      ) {
+        using enum HttpStatus;
+        if (Request.body.size() > MaxBatchBodyBytes) {
+          respondError(
+              Request,
+              Response,
+              BadRequest,
+              std::format("Batch body exceeds {} bytes", MaxBatchBodyBytes)
+          );
+          return;
+        }
+
+        BatchRequest Batch;
+        if (auto JsonError = glz::read<JsonOpts>(Batch, Request.body)) {
+          spdlog::warn("POST /batch - Invalid JSON in request body");
+          respondError(Request, Response, BadRequest, "Invalid JSON");
+          return;
+        }
+        if (Batch.Operations.size() > MaxBatchOperations) {
+          respondError(
+              Request,
+              Response,
+              BadRequest,
+              std::format(
+                  "Batch holds {} operations, at most {} are allowed",
+                  Batch.Operations.size(),
+                  MaxBatchOperations
+              )
+          );
+          return;
+        }
+
+        spdlog::debug(
+            "POST /batch - Dispatching {} operations", Batch.Operations.size()
+        );
+        BatchResponse Output;
+        Output.Results.reserve(Batch.Operations.size());
+        bool Failed = false;
+        for (const auto &Operation : Batch.Operations) {
+          if (Failed && Batch.StopOnError.value_or(false)) {
+            Output.Results.push_back(errorResult(
+                UnprocessableEntity, "Skipped after an earlier failure"
+            ));
+            continue;
+          }
+          Output.Results.push_back(dispatch(Mounts, Request, Operation));
+          Failed = Failed || Output.Results.back().Status >= 400;
+        }
+        respondJson(Response, Ok, Output);
+      }
+  );
+}
+
+} // namespace insights::core
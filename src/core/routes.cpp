@@ -1,15 +1,19 @@
 #include "insights/core/routes.hpp"
 
+#include "insights/core/json.hpp"
 #include "insights/core/timestamp.hpp"
 
 #include <chrono>
-#include <pqxx/pqxx>
 #include <spdlog/spdlog.h>
 
 namespace insights::core {
 
 void registerCoreRoutes(
-    glz::http_router &Router, std::shared_ptr<db::Database> Database
+    glz::http_router &Router,
+    std::shared_ptr<db::Database> Database,
+    std::shared_ptr<ResponseCache> Cache,
+    std::shared_ptr<Metrics> Metrics,
+    std::shared_ptr<Startup> Startup
 ) {
   // Healthcheck endpoint
   Router.get(
@@ -17,30 +21,44 @@ void registerCoreRoutes(
         spdlog::debug("GET /health - Running healthcheck");
 
         // Test database connectivity
-        try {
-          pqxx::work Tx(Database->Cx);
-          Tx.exec("SELECT 1");
-
-          spdlog::debug("GET /health - Database connection healthy");
-          Response.status(200).json(
-              {{"status", "healthy"}, {"database", "connected"}}
-          );
-        } catch (const std::exception &Err) {
+        if (auto Ping = Database->ping(); !Ping) {
           spdlog::error(
-              "GET /health - Database connection failed: {}", Err.what()
+              "GET /health - Database connection failed: {}",
+              Ping.error().Message
           );
           Response.status(503).json(
               {{"status", "unhealthy"},
                {"database", "disconnected"},
-               {"error", Err.what()}}
+               {"error", Ping.error().Message}}
           );
+          return;
         }
+
+        spdlog::debug("GET /health - Database connection healthy");
+        Response.status(200).json(
+            {{"status", "healthy"}, {"database", "connected"}}
+        );
+      }
+  );
+
+  // Readiness: 200 once the database is connected and the read state is
+  // loaded, 503 while warming up; the body is the startup timeline.
+  Router.get(
+      "/ready",
+      [Startup](const glz::request &Request, glz::response &Response) {
+        auto Report = Startup->report();
+        respond(
+            Request,
+            Response,
+            Report.Ready ? HttpStatus::Ok : HttpStatus::ServiceUnavailable,
+            Report
+        );
       }
   );
 
   Router.get(
       "/tasks/github-sync",
-      [Database](const glz::request &, glz::response &Response) {
+      [Database](const glz::request &Request, glz::response &Response) {
         spdlog::debug("GET /tasks/github-sync - Fetching task status");
 
         auto Interval =
@@ -53,8 +71,11 @@ void registerCoreRoutes(
               "GET /tasks/github-sync - Failed: {}",
               StatusResult.error().Message
           );
-          Response.status(500).json(
-              {{"error", StatusResult.error().Message}}
+          respondError(
+              Request,
+              Response,
+              HttpStatus::InternalServerError,
+              StatusResult.error().Message
           );
           return;
         }
@@ -77,7 +98,40 @@ void registerCoreRoutes(
             .LastAttemptAccountsFailed =
                 StatusResult->LastAttemptAccountsFailed,
         };
-        Response.status(200).json(Output);
+        respond(Request, Response, HttpStatus::Ok, Output);
+      }
+  );
+
+  Router.get(
+      "/cache/stats",
+      [Cache](const glz::request &Request, glz::response &Response) {
+        spdlog::debug("GET /cache/stats - Reading response cache counters");
+        auto Stats = Cache->stats();
+        auto Lookups = Stats.Hits + Stats.Misses;
+        respond(
+            Request,
+            Response,
+            HttpStatus::Ok,
+            CacheStatsResponse{
+                .Hits = Stats.Hits,
+                .Misses = Stats.Misses,
+                .Invalidations = Stats.Invalidations,
+                .Entries = Stats.Entries,
+                .HitRatio = Lookups == 0 ? 0.0
+                                         : static_cast<double>(Stats.Hits) /
+                                               static_cast<double>(Lookups),
+            }
+        );
+      }
+  );
+
+  // Prometheus scrape endpoint
+  Router.get(
+      "/metrics", [Metrics](const glz::request &, glz::response &Response) {
+        spdlog::debug("GET /metrics - Rendering metrics");
+        Response.status(static_cast<int>(HttpStatus::Ok))
+            .content_type(PrometheusMediaType)
+            .body(Metrics->render());
       }
   );
 
@@ -92,18 +146,34 @@ void registerCoreRoutes(
             {"method", "GET"},
             {"description",
              "Health check endpoint - verifies database connectivity"}},
+           {{"path", "/ready"},
+            {"method", "GET"},
+            {"description",
+             "Readiness check - 200 once warm, with startup timings"}},
            {{"path", "/routes"},
             {"method", "GET"},
             {"description", "Lists all available API endpoints"}},
            {{"path", "/tasks/github-sync"},
             {"method", "GET"},
             {"description", "Get GitHub sync task status and next run timing"}},
+           {{"path", "/cache/stats"},
+            {"method", "GET"},
+            {"description", "Response cache hit, miss and invalidation counters"}},
+           {{"path", "/metrics"},
+            {"method", "GET"},
+            {"description", "Prometheus request and process metrics"}},
+           {{"path", "/batch"},
+            {"method", "POST"},
+            {"description", "Run up to 100 API operations in one request"}},
            {{"path", "/api/github/accounts"},
             {"method", "GET"},
             {"description", "Get all github accounts"}},
            {{"path", "/api/github/accounts"},
             {"method", "POST"},
             {"description", "Create a new github account"}},
+           {{"path", "/api/github/accounts:bulk"},
+            {"method", "POST"},
+            {"description", "Create many github accounts in one request"}},
            {{"path", "/api/github/accounts/:id"},
             {"method", "GET"},
             {"description", "Get a specific github account by ID"}},
@@ -116,9 +186,15 @@ void registerCoreRoutes(
            {{"path", "/api/github/repos"},
             {"method", "POST"},
             {"description", "Create a new github repository"}},
+           {{"path", "/api/github/repos:bulk"},
+            {"method", "POST"},
+            {"description", "Create many github repositories in one request"}},
            {{"path", "/api/github/repos/:id"},
             {"method", "GET"},
             {"description", "Get a specific github repository by ID"}},
+           {{"path", "/api/github/repos/by-name/:owner/:name"},
+            {"method", "GET"},
+            {"description", "Get a github repository by owner and name"}},
            {{"path", "/api/github/repos/:id/sync"},
             {"method", "POST"},
             {"description", "Sync a specific github repository by ID"}},
@@ -127,7 +203,13 @@ void registerCoreRoutes(
             {"description", "Update a github repository by ID"}},
            {{"path", "/api/github/repos/:id"},
             {"method", "DELETE"},
-            {"description", "Soft delete a github repository by ID"}}}}}
+            {"description", "Soft delete a github repository by ID"}},
+           {{"path", "/api/github/search"},
+            {"method", "GET"},
+            {"description", "Search repositories and accounts by name"}},
+           {{"path", "/api/github/stats"},
+            {"method", "GET"},
+            {"description", "Star, fork, view, clone and follower totals"}}}}}
     );
   });
 }
@@ -0,0 +1,78 @@
+#include "insights/github/live.hpp"
+
+#include "insights/core/json.hpp"
+#include "insights/github/routes.hpp"
+
+#include "glaze/json/read.hpp"
+#include "glaze/net/websocket_connection.hpp"
+
+#include <format>
+#include <memory>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <string_view>
+
+namespace insights::github {
+
+// Replies to the client that sent a bad command; the connection stays open.
+template <typename Connection>
+static void sendError(Connection &Conn, std::string_view Message) {
+  if (auto Body = core::writeJson(core::ErrorResponse{Message})) {
+    Conn.send_text(*Body);
+  }
+}
+
+auto createLiveServer(std::shared_ptr<LiveHub> Hub)
+    -> std::shared_ptr<glz::websocket_server> {
+  auto Server = std::make_shared<glz::websocket_server>();
+
+  Server->on_open([Hub](auto Conn, const auto &...) {
+    // The hub only keeps a weak reference: a closed connection makes its
+    // Sender return false and the next broadcast prunes it.
+    Hub->connect(
+        Conn.get(),
+        [Weak = std::weak_ptr(Conn)](const LiveHub::Frame &Frame) {
+          auto Locked = Weak.lock();
+          if (!Locked) {
+            return false;
+          }
+          Locked->send_text(*Frame);
+          return true;
+        }
+    );
+  });
+
+  Server->on_message([Hub](auto Conn, std::string_view Message, auto...) {
+    LiveCommand Command;
+    if (auto JsonError = glz::read_json(Command, Message)) {
+      sendError(*Conn, "Invalid command");
+      return;
+    }
+    for (const auto &Name : Command.Subscribe) {
+      auto Topic = parseLiveTopic(Name);
+      if (!Topic) {
+        sendError(*Conn, std::format("Unknown topic '{}'", Name));
+        continue;
+      }
+      Hub->subscribe(Conn.get(), *Topic);
+    }
+    for (const auto &Name : Command.Unsubscribe) {
+      if (auto Topic = parseLiveTopic(Name)) {
+        Hub->unsubscribe(Conn.get(), *Topic);
+      }
+    }
+  });
+
+  Server->on_close([Hub](auto Conn, const auto &...) {
+    Hub->disconnect(Conn.get());
+  });
+
+  Server->on_error([Hub](auto Conn, const auto &Ec) {
+    spdlog::debug("Live connection error: {}", Ec.message());
+    Hub->disconnect(Conn.get());
+  });
+
+  return Server;
+}
+
+} // namespace insights::github
@@ -1,26 +1,735 @@
 #include "insights/github/routes.hpp"
 
 #include "glaze/net/http_router.hpp"
+#include "insights/core/arena.hpp"
+#include "insights/core/fields.hpp"
 #include "insights/core/http.hpp"
+#include "insights/core/json.hpp"
+#include "insights/core/list_query.hpp"
+#include "insights/core/negotiation.hpp"
+#include "insights/core/query.hpp"
 #include "insights/core/result.hpp"
+#include "insights/core/uuid.hpp"
 #include "insights/db/db.hpp"
+#include "insights/github/cache.hpp"
 #include "insights/github/models.hpp"
+#include "insights/github/search.hpp"
+#include "insights/github/state.hpp"
 #include "insights/server/dependencies.hpp"
 #include "insights/github/tasks.hpp"
 
 #include <algorithm>
 #include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <memory_resource>
+#include <optional>
 #include <glaze/core/read.hpp>
+#include <glaze/json/write.hpp>
 #include <memory>
+#include <span>
 #include <spdlog/spdlog.h>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace insights::github {
 
+namespace {
+
+// Per-thread body buffers are reused so steady-state responses do not grow
+// a string from zero each time, but a full export can run to megabytes;
+// past this capacity the buffer is released once the response has its copy
+// instead of staying pinned on every server thread.
+constexpr std::size_t MaxRetainedBody = std::size_t{1} << 20;
+
+struct ReleaseLargeBody {
+  std::string &Body;
+  ~ReleaseLargeBody() {
+    if (Body.capacity() > MaxRetainedBody) {
+      std::string{}.swap(Body);
+    }
+  }
+};
+
+// Serves Key from the response cache in the negotiated format. On a miss,
+// Load(Format) serializes the body (into a per-thread buffer) and a copy is
+// cached for the next reader.
+template <typename Loader>
+void respondCached(
+    core::ResponseCache &Cache,
+    std::string_view Key,
+    const glz::request &Request,
+    glz::response &Response,
+    Loader &&Load
+) {
+  using enum core::HttpStatus;
+  auto Format = core::negotiate(Request);
+  if (Format == core::MediaType::NdJson) {
+    Format = core::MediaType::Json;
+  }
+  auto VariantKey = cache::variantKey(Key, Format);
+
+  if (auto Body = Cache.get(VariantKey)) {
+    Response.status(static_cast<int>(Ok))
+        .content_type(core::contentType(Format))
+        .body(*Body);
+    return;
+  }
+
+  auto Ticket = Cache.ticket(VariantKey);
+  auto Body = std::forward<Loader>(Load)(Format);
+  if (!Body) {
+    core::respondError(
+        Response, InternalServerError, Body.error().Message, Format
+    );
+    return;
+  }
+  Response.status(static_cast<int>(Ok))
+      .content_type(core::contentType(Format))
+      .body(*Body);
+  Cache.put(std::move(VariantKey), std::string(*Body), Ticket);
+}
+
+// Serializes every live entity of type T. Served from the snapshot once it
+// is loaded — the live rows' pointers are gathered into the request arena
+// and written through the models' glz::meta projections. Before that (e.g.
+// the startup load failed) the database is queried directly. Like every
+// list path, soft-deleted rows are left out.
+template <typename T>
+auto writeEntities(
+    db::Database &Database,
+    const ReadState &State,
+    std::vector<std::shared_ptr<const T>> Snapshot::*Entities,
+    core::MediaType Format,
+    std::size_t &Count
+) -> std::expected<std::string_view, core::Error> {
+  if (auto Current = State.Snapshot->current()) {
+    const auto &All = (*Current).*Entities;
+    std::pmr::vector<std::shared_ptr<const T>> Live(core::requestResource());
+    Live.reserve(All.size());
+    for (const auto &Entity : All) {
+      if (!Entity->DeletedAt) {
+        Live.push_back(Entity);
+      }
+    }
+    Count = Live.size();
+    return core::writeBody(Format, Live);
+  }
+
+  auto FromDatabase = Database.getAll<T>();
+  if (!FromDatabase) {
+    return std::unexpected(FromDatabase.error());
+  }
+  Count = FromDatabase->size();
+  return core::writeBody(Format, *FromDatabase);
+}
+
+// Writes every live entity of type T as newline-delimited JSON, one object
+// per line, for full exports. Rows are serialized one at a time from the
+// snapshot (or, before it is loaded, from a database cursor), so no
+// intermediate entity vector or JSON array is built. A row that fails to
+// serialize fails the whole export with 500 rather than being left out.
+// Bypasses the response cache: exports are rare and would only evict hot
+// entries.
+//
+// This is not streaming: glaze hands the router's response to the socket
+// as one complete body, so the whole export, the cursor path included, is
+// assembled in a per-thread buffer first, and that buffer is released
+// afterwards when it grew past MaxRetainedBody.
+template <typename T>
+void respondNdjson(
+    db::Database &Database,
+    const ReadState &State,
+    std::vector<std::shared_ptr<const T>> Snapshot::*Entities,
+    std::string_view Route,
+    glz::response &Response
+) {
+  using enum core::HttpStatus;
+  thread_local std::string Body;
+  thread_local std::string Line;
+  Body.clear();
+  ReleaseLargeBody Release{Body};
+
+  std::optional<core::Error> Failed;
+  auto Append = [&Failed](const T &Entity) {
+    if (Failed) {
+      return;
+    }
+    if (auto JsonError = glz::write_json(Entity, Line)) {
+      Failed = core::Error{glz::format_error(JsonError)};
+      return;
+    }
+    Body.append(Line);
+    Body.push_back('\n');
+  };
+
+  std::size_t Count = 0;
+  if (auto Current = State.Snapshot->current()) {
+    for (const auto &Entity : (*Current).*Entities) {
+      if (!Entity->DeletedAt) {
+        Append(*Entity);
+        ++Count;
+      }
+    }
+  } else {
+    auto Streamed = Database.forEach<T>(Append);
+    if (!Streamed) {
+      spdlog::error(
+          "GET {} - Database error: {}", Route, Streamed.error().Message
+      );
+      core::respondError(
+          Response, InternalServerError, Streamed.error().Message
+      );
+      return;
+    }
+    Count = *Streamed;
+  }
+  if (Failed) {
+    spdlog::error("GET {} - Serialization error: {}", Route, Failed->Message);
+    core::respondError(Response, InternalServerError, Failed->Message);
+    return;
+  }
+
+  spdlog::debug("GET {} - Exported {} rows as NDJSON", Route, Count);
+  Response.status(static_cast<int>(Ok))
+      .content_type(core::NdJsonMediaType)
+      .body(Body);
+}
+
+// A sparse field mask is applied by the JSON writer only; a client that
+// asked for BEVE gets 406 rather than a body in a format it did not accept.
+bool rejectSparseBeve(
+    core::MediaType Format,
+    std::string_view Route,
+    const glz::request &Request,
+    glz::response &Response
+) {
+  if (Format != core::MediaType::Beve) {
+    return false;
+  }
+  spdlog::warn("GET {} - ?fields= requested as BEVE", Route);
+  core::respondError(
+      Request,
+      Response,
+      core::HttpStatus::NotAcceptable,
+      "?fields= is served as JSON or NDJSON only"
+  );
+  return true;
+}
+
+// Lists the live entities with only the fields named in ?fields= (e.g.
+// "Name,Stars"), as a JSON array or, when negotiated, NDJSON. The mask is
+// validated against the schema, applied at serialization when serving from
+// the snapshot, and pushed down into the SELECT column list when reading
+// from the database. Sparse bodies are not cached; they are cheap to build
+// from the snapshot.
+template <typename T>
+void respondSparse(
+    db::Database &Database,
+    const ReadState &State,
+    std::vector<std::shared_ptr<const T>> Snapshot::*Entities,
+    std::string_view FieldList,
+    std::string_view Route,
+    const glz::request &Request,
+    glz::response &Response
+) {
+  using enum core::HttpStatus;
+  auto Mask = core::parseFields<T>(FieldList);
+  if (!Mask) {
+    spdlog::warn("GET {} - {}", Route, Mask.error().Message);
+    core::respondError(Request, Response, BadRequest, Mask.error().Message);
+    return;
+  }
+
+  auto Format = core::negotiate(Request);
+  if (rejectSparseBeve(Format, Route, Request, Response)) {
+    return;
+  }
+  bool Ndjson = Format == core::MediaType::NdJson;
+  thread_local std::string Body;
+  Body.clear();
+  ReleaseLargeBody Release{Body};
+  if (!Ndjson) {
+    Body.push_back('[');
+  }
+  bool First = true;
+  auto Append = [&](const T &Entity) {
+    if (Ndjson) {
+      core::appendPartialJson(Entity, *Mask, Body);
+      Body.push_back('\n');
+      return;
+    }
+    if (!First) {
+      Body.push_back(',');
+    }
+    First = false;
+    core::appendPartialJson(Entity, *Mask, Body);
+  };
+
+  if (auto Current = State.Snapshot->current()) {
+    for (const auto &Entity : (*Current).*Entities) {
+      if (!Entity->DeletedAt) {
+        Append(*Entity);
+      }
+    }
+  } else {
+    auto FromDatabase = Database.getAllFields<T>(*Mask);
+    if (!FromDatabase) {
+      spdlog::error(
+          "GET {} - Database error: {}", Route, FromDatabase.error().Message
+      );
+      core::respondError(
+          Request, Response, InternalServerError, FromDatabase.error().Message
+      );
+      return;
+    }
+    for (const auto &Entity : *FromDatabase) {
+      Append(Entity);
+    }
+  }
+  if (!Ndjson) {
+    Body.push_back(']');
+  }
+
+  Response.status(static_cast<int>(Ok))
+      .content_type(Ndjson ? core::NdJsonMediaType : core::JsonMediaType)
+      .body(Body);
+}
+
+template <typename T> const T &entityOf(const T &Entity) { return Entity; }
+
+template <typename T>
+const T &entityOf(const std::shared_ptr<const T> &Entity) {
+  return *Entity;
+}
+
+// Serializes a filtered list in Format: NDJSON lines, a JSON array of
+// sparse objects when the query carries a field mask, or else the full
+// projection through writeBody.
+template <typename T, typename Range>
+auto writeList(
+    const Range &Entities, const core::ListQuery &Query, core::MediaType Format
+) -> std::expected<std::string_view, core::Error> {
+  if (Format != core::MediaType::NdJson && !Query.Mask) {
+    return core::writeBody(Format, Entities);
+  }
+
+  thread_local std::string Body;
+  thread_local std::string Line;
+  Body.clear();
+  bool Ndjson = Format == core::MediaType::NdJson;
+  if (!Ndjson) {
+    Body.push_back('[');
+  }
+  bool First = true;
+  for (const auto &Item : Entities) {
+    const T &Entity = entityOf<T>(Item);
+    if (!Ndjson && !First) {
+      Body.push_back(',');
+    }
+    First = false;
+    if (Query.Mask) {
+      core::appendPartialJson(Entity, *Query.Mask, Body);
+    } else if (auto JsonError = glz::write_json(Entity, Line)) {
+      return std::unexpected(core::Error{glz::format_error(JsonError)});
+    } else {
+      Body.append(Line);
+    }
+    if (Ndjson) {
+      Body.push_back('\n');
+    }
+  }
+  if (!Ndjson) {
+    Body.push_back(']');
+  }
+  return std::string_view{Body};
+}
+
+// Lists entities matching ?<column>=, ?min_<column>=, ?max_<column>=,
+// ordered by ?sort= and capped by ?limit= (see core/list_query.hpp). From
+// the snapshot this is a scan plus a partial sort; before the snapshot is
+// loaded the query is pushed down to Postgres as parameterized SQL. Results
+// are not cached — the key space is unbounded.
+template <typename T>
+void respondList(
+    db::Database &Database,
+    const ReadState &State,
+    std::vector<std::shared_ptr<const T>> Snapshot::*Entities,
+    const core::ListQuery &Query,
+    std::string_view Route,
+    const glz::request &Request,
+    glz::response &Response
+) {
+  using enum core::HttpStatus;
+  auto Format = core::negotiate(Request);
+  if (Query.Mask && rejectSparseBeve(Format, Route, Request, Response)) {
+    return;
+  }
+
+  std::expected<std::string_view, core::Error> Body;
+  std::size_t Count = 0;
+  if (auto Current = State.Snapshot->current()) {
+    std::pmr::vector<std::shared_ptr<const T>> Matching(
+        core::requestResource()
+    );
+    for (const auto &Entity : (*Current).*Entities) {
+      if (core::matches(*Entity, Query)) {
+        Matching.push_back(Entity);
+      }
+    }
+    auto Keep = std::min(Matching.size(), Query.Limit.value_or(SIZE_MAX));
+    if (Query.Sort) {
+      auto Before = [&](const auto &Lhs, const auto &Rhs) {
+        return core::orderedBefore(*Lhs, *Rhs, *Query.Sort);
+      };
+      std::partial_sort(
+          Matching.begin(), Matching.begin() + Keep, Matching.end(), Before
+      );
+    }
+    Matching.resize(Keep);
+    Count = Matching.size();
+    Body = writeList<T>(Matching, Query, Format);
+  } else {
+    auto FromDatabase = Database.list<T>(Query);
+    if (!FromDatabase) {
+      Body = std::unexpected(FromDatabase.error());
+    } else {
+      Count = FromDatabase->size();
+      Body = writeList<T>(*FromDatabase, Query, Format);
+    }
+  }
+
+  if (!Body) {
+    spdlog::error(
+        "GET {} - List query failed: {}", Route, Body.error().Message
+    );
+    core::respondError(
+        Request, Response, InternalServerError, Body.error().Message
+    );
+    return;
+  }
+
+  spdlog::debug("GET {} - Listed {} rows", Route, Count);
+  Response.status(static_cast<int>(Ok))
+      .content_type(
+          Format == core::MediaType::NdJson ? core::NdJsonMediaType
+                                            : core::contentType(Format)
+      )
+      .body(*Body);
+}
+
+// Dispatches a GET on a list route: filtered queries, sparse fieldsets,
+// NDJSON exports and finally the cached full list.
+template <typename T, typename Loader>
+void respondListRoute(
+    db::Database &Database,
+    const ReadState &State,
+    std::vector<std::shared_ptr<const T>> Snapshot::*Entities,
+    std::string_view CacheKey,
+    std::string_view Route,
+    const glz::request &Request,
+    glz::response &Response,
+    Loader &&Load
+) {
+  auto Query = core::parseListQuery<T>(Request);
+  if (!Query) {
+    spdlog::warn("GET {} - {}", Route, Query.error().Message);
+    core::respondError(
+        Request, Response, core::HttpStatus::BadRequest, Query.error().Message
+    );
+    return;
+  }
+  if (!Query->Filters.empty() || Query->Sort || Query->Limit) {
+    respondList<T>(
+        Database, State, Entities, *Query, Route, Request, Response
+    );
+    return;
+  }
+  if (auto Fields = core::queryParam(Request, "fields")) {
+    respondSparse<T>(
+        Database, State, Entities, *Fields, Route, Request, Response
+    );
+    return;
+  }
+  if (core::negotiate(Request) == core::MediaType::NdJson) {
+    respondNdjson<T>(Database, State, Entities, Route, Response);
+    return;
+  }
+  respondCached(
+      *State.Cache, CacheKey, Request, Response, std::forward<Loader>(Load)
+  );
+}
+
+// Looks up one entity by Id in the snapshot. Ids the snapshot does not know
+// (rows written behind the server's back) are read from the database. The
+// row is not folded into the snapshot: it may already be older than a
+// concurrent write that was recorded while we were reading it.
+template <typename T>
+auto findEntity(
+    db::Database &Database, const ReadState &State, const core::Uuid &Id
+) -> std::expected<std::shared_ptr<const T>, core::Error> {
+  if (auto Current = State.Snapshot->current()) {
+    std::shared_ptr<const T> Entity;
+    if constexpr (std::is_same_v<T, models::Account>) {
+      Entity = Current->account(Id);
+    } else {
+      Entity = Current->repository(Id);
+    }
+    if (Entity) {
+      return Entity;
+    }
+  }
+
+  auto FromDatabase = Database.get<T>(Id);
+  if (!FromDatabase) {
+    return std::unexpected(FromDatabase.error());
+  }
+  return std::make_shared<const T>(std::move(*FromDatabase));
+}
+
+// The database side of GET /repos/by-name, for when the snapshot is not
+// loaded. Same matching as Snapshot::repositoryByName: live rows only, names
+// compared case-insensitively.
+auto readRepositoryByName(
+    db::Database &Database, std::string_view Owner, std::string_view Name
+) -> std::expected<std::optional<models::Repository>, core::Error> {
+  return Database.read(
+      "readRepositoryByName",
+      [&](pqxx::read_transaction &Tx) -> std::optional<models::Repository> {
+        static const std::string Query = std::format(
+            "SELECT r.* FROM {} r JOIN {} a ON a.id = r.account_id "
+            "WHERE lower(a.name) = lower($1) AND lower(r.name) = lower($2) "
+            "AND a.deleted_at IS NULL AND r.deleted_at IS NULL LIMIT 1",
+            core::DbTraits<models::Repository>::TableName,
+            core::DbTraits<models::Account>::TableName
+        );
+        auto Result = Tx.exec(pqxx::zview{Query}, pqxx::params{Owner, Name});
+        if (Result.empty()) {
+          return std::nullopt;
+        }
+        return core::DbTraits<models::Repository>::fromRow(Result[0]);
+      }
+  );
+}
+
+// The database side of GET /search, for when the search index is not
+// loaded: prefix matches only, ranked the same way. The pattern is anchored,
+// so there is no '%q%' scan of either table.
+auto searchDatabase(
+    db::Database &Database, std::string_view Query, std::size_t Limit
+) -> std::expected<SearchResults, core::Error> {
+  std::string Pattern;
+  for (char Ch : lowerName(Query)) {
+    if (Ch == '%' || Ch == '_' || Ch == '\\') {
+      Pattern.push_back('\\');
+    }
+    Pattern.push_back(Ch);
+  }
+  Pattern.push_back('%');
+
+  return Database.read(
+      "searchDatabase",
+      [&](pqxx::read_transaction &Tx) {
+        static const std::string RepositoryQuery = std::format(
+            "SELECT * FROM {} WHERE deleted_at IS NULL "
+            "AND lower(name) LIKE $1 ORDER BY stars DESC, lower(name) "
+            "LIMIT $2",
+            core::DbTraits<models::Repository>::TableName
+        );
+        static const std::string AccountQuery = std::format(
+            "SELECT * FROM {} WHERE deleted_at IS NULL "
+            "AND lower(name) LIKE $1 ORDER BY followers DESC, lower(name) "
+            "LIMIT $2",
+            core::DbTraits<models::Account>::TableName
+        );
+        pqxx::params Params{Pattern, static_cast<long long>(Limit)};
+        SearchResults Results;
+        for (const auto &Row :
+             Tx.exec(pqxx::zview{RepositoryQuery}, Params)) {
+          Results.Repositories.push_back(
+              std::make_shared<const models::Repository>(
+                  core::DbTraits<models::Repository>::fromRow(Row)
+              )
+          );
+        }
+        for (const auto &Row : Tx.exec(pqxx::zview{AccountQuery}, Params)) {
+          Results.Accounts.push_back(std::make_shared<const models::Account>(
+              core::DbTraits<models::Account>::fromRow(Row)
+          ));
+        }
+        return Results;
+      }
+  );
+}
+
+OutputAccountSchema toOutput(const models::Account &Account) {
+  return OutputAccountSchema{
+      .Id = Account.Id,
+      .Name = Account.Name,
+      .Followers = Account.Followers,
+  };
+}
+
+OutputRepositorySchema toOutput(const models::Repository &Repository) {
+  return OutputRepositorySchema{
+      .Id = Repository.Id,
+      .Name = Repository.Name,
+      .AccountId = Repository.AccountId,
+      .Clones = Repository.Clones,
+      .Forks = Repository.Forks,
+      .Stars = Repository.Stars,
+      .Subscribers = Repository.Subscribers,
+      .Views = Repository.Views,
+  };
+}
+
+// Inserts the valid items of a bulk request in one statement and fills in
+// their results. Items is the full request, in order; Results already holds
+// an "invalid" entry for every item that failed validation and an empty
+// Status for the rest. Items sharing a natural key (NaturalKey) are sent
+// once and all report the same row. The rows actually inserted are passed
+// to Record in one span, so the read state is updated with one snapshot
+// copy per request. The dedupe tables live in the request arena.
+template <typename T, typename KeyFn, typename RecordFn>
+void respondBulk(
+    db::Database &Database,
+    std::span<const T> Items,
+    BulkResponse &Output,
+    KeyFn &&NaturalKey,
+    RecordFn &&Record,
+    std::string_view Route,
+    const glz::request &Request,
+    glz::response &Response
+) {
+  using enum core::HttpStatus;
+  auto *Arena = core::requestResource();
+  std::pmr::unordered_set<std::pmr::string> Unique(Arena);
+  std::pmr::vector<T> ToInsert(Arena);
+  for (std::size_t I = 0; I < Items.size(); ++I) {
+    if (Output.Results[I].Status.empty() &&
+        Unique.insert(NaturalKey(Items[I])).second) {
+      ToInsert.push_back(Items[I]);
+    }
+  }
+
+  auto Rows = Database.insertMany<T>(ToInsert);
+  if (!Rows) {
+    spdlog::error(
+        "POST {} - Bulk insert of {} rows failed: {}",
+        Route,
+        ToInsert.size(),
+        Rows.error().Message
+    );
+    core::respondError(
+        Request, Response, InternalServerError, Rows.error().Message
+    );
+    return;
+  }
+
+  std::pmr::unordered_map<std::pmr::string, const db::Upserted<T> *> ByKey(
+      Arena
+  );
+  std::pmr::vector<T> Inserted(Arena);
+  for (const auto &Row : *Rows) {
+    ByKey.emplace(NaturalKey(Row.Entity), &Row);
+    if (Row.Inserted) {
+      Inserted.push_back(Row.Entity);
+    }
+  }
+  Record(std::span<const T>(Inserted));
+
+  std::pmr::unordered_set<const db::Upserted<T> *> Claimed(Arena);
+  for (std::size_t I = 0; I < Items.size(); ++I) {
+    auto &Result = Output.Results[I];
+    if (!Result.Status.empty()) {
+      ++Output.Invalid;
+      continue;
+    }
+    auto Found = ByKey.find(NaturalKey(Items[I]));
+    if (Found == ByKey.end()) {
+      Result = {.Status = "invalid", .Error = "Row was not returned"};
+      ++Output.Invalid;
+      continue;
+    }
+    // The key constraint also covers soft-deleted rows, which the API no
+    // longer serves; pointing the item at one would hand out a dead id.
+    if (Found->second->Entity.DeletedAt) {
+      Result = {.Status = "invalid", .Error = "Name belongs to a deleted row"};
+      ++Output.Invalid;
+      continue;
+    }
+    Result.Id = Found->second->Entity.Id;
+    // Only the first occurrence of a new key counts as the creation.
+    if (Found->second->Inserted && Claimed.insert(Found->second).second) {
+      Result.Status = "created";
+      ++Output.Created;
+    } else {
+      Result.Status = "existing";
+      ++Output.Existing;
+    }
+  }
+
+  spdlog::info(
+      "POST {} - {} created, {} existing, {} invalid",
+      Route,
+      Output.Created,
+      Output.Existing,
+      Output.Invalid
+  );
+  core::respond(Request, Response, Ok, Output);
+}
+
+template <typename Schema>
+auto readBulkBody(
+    std::string_view Route,
+    const glz::request &Request,
+    glz::response &Response
+) -> std::optional<std::pmr::vector<Schema>> {
+  using enum core::HttpStatus;
+  std::pmr::vector<Schema> Items(core::requestResource());
+  if (auto JsonError = glz::read<core::JsonOpts>(Items, Request.body)) {
+    spdlog::warn("POST {} - Invalid JSON in request body", Route);
+    core::respondError(Request, Response, BadRequest, "Invalid JSON");
+    return std::nullopt;
+  }
+  if (Items.empty() || Items.size() > MaxBulkItems) {
+    core::respondError(
+        Request,
+        Response,
+        BadRequest,
+        std::format("Expected between 1 and {} items", MaxBulkItems)
+    );
+    return std::nullopt;
+  }
+  return Items;
+}
+
+} // namespace
+
+auto makeSyncHooks(std::shared_ptr<ReadState> State) -> tasks::SyncHooks {
+  return tasks::SyncHooks{
+      .OnRepositoryCommitted =
+          [State](const models::Repository &Repository) {
+            recordRepository(*State, Repository);
+          },
+      .OnAccountCommitted =
+          [State](const models::Account &Account) {
+            recordAccount(*State, Account);
+          },
+  };
+}
+
 auto registerRoutes(
     glz::http_router &Router,
     std::shared_ptr<db::Database> &Database,
+    std::shared_ptr<ReadState> State,
     const core::Config &Config
 ) -> std::expected<void, core::Error> {
   using enum core::HttpStatus;
@@ -28,46 +737,48 @@ auto registerRoutes(
   // Get All Accounts
   Router.get(
       "/accounts",
-      [Database](const glz::request &Request, glz::response &Response) {
-        spdlog::debug("GET /accounts - Fetching all accounts");
-        auto Result = Database->getAll<github::models::Account>();
+      [Database, State](const glz::request &Request, glz::response &Response) {
+        respondListRoute<models::Account>(
+            *Database,
+            *State,
+            &Snapshot::Accounts,
+            cache::AccountsKey,
+            "/accounts",
+            Request,
+            Response,
+            [&](core::MediaType Format
+            ) -> std::expected<std::string_view, core::Error> {
+              spdlog::debug("GET /accounts - Fetching all accounts");
+              std::size_t Count = 0;
+              auto Result = writeEntities<models::Account>(
+                  *Database, *State, &Snapshot::Accounts, Format, Count
+              );
 
-        if (!Result) {
-          spdlog::error(
-              "GET /accounts - Database error: {}", Result.error().Message
-          );
-          Response.status(static_cast<int>(InternalServerError))
-              .json({{"error", Result.error().Message}});
-          return;
-        }
-
-        spdlog::debug("GET /accounts - Retrieved {} accounts", Result->size());
-        std::vector<github::OutputAccountSchema> Output;
-        for (const auto &Account : *Result) {
-          Output.emplace_back(
-              OutputAccountSchema{
-                  .Id = Account.Id,
-                  .Name = Account.Name,
-                  .Followers = Account.Followers,
+              if (!Result) {
+                spdlog::error(
+                    "GET /accounts - Database error: {}",
+                    Result.error().Message
+                );
+                return Result;
               }
-          );
-        }
 
-        Response.status(static_cast<int>(Ok)).json(Output);
+              spdlog::debug("GET /accounts - Retrieved {} accounts", Count);
+              return Result;
+            }
+        );
       }
   );
 
   // Create Account
   Router.post(
       "/accounts",
-      [Database](const glz::request &Request, glz::response &Response) {
+      [Database, State](const glz::request &Request, glz::response &Response) {
         // Validate Payload
         CreateAccountSchema AccountData;
         if (auto JsonError =
                 glz::read<core::JsonOpts>(AccountData, Request.body)) {
           spdlog::warn("POST /accounts - Invalid JSON in request body");
-          Response.status(static_cast<int>(BadRequest))
-              .json({{"error", "Invalid JSON"}});
+          core::respondError(Request, Response, BadRequest, "Invalid JSON");
           return;
         }
 
@@ -93,133 +804,182 @@ auto registerRoutes(
               AccountData.Name,
               Result.error().Message
           );
-          Response.status(static_cast<int>(InternalServerError))
-              .json({{"error", Result.error().Message}});
+          core::respondError(
+              Request, Response, InternalServerError, Result.error().Message
+          );
           return;
         }
+        recordAccount(*State, *Result);
         spdlog::info(
             "POST /accounts - Created account '{}' with ID: {}",
             Result->Name,
             Result->Id
         );
-        auto Output = OutputAccountSchema{
-            .Id = Result->Id,
-            .Name = Result->Name,
-            .Followers = Result->Followers,
-        };
-        Response.status(static_cast<int>(Created)).json(Output);
+        core::respond(Request, Response, Created, *Result);
+      }
+  );
+
+  // Bulk Create Accounts
+  Router.post(
+      "/accounts:bulk",
+      [Database, State](const glz::request &Request, glz::response &Response) {
+        auto Items = readBulkBody<CreateAccountSchema>(
+            "/accounts:bulk", Request, Response
+        );
+        if (!Items) {
+          return;
+        }
+
+        BulkResponse Output;
+        Output.Results.resize(Items->size());
+        std::pmr::vector<models::Account> Accounts(core::requestResource());
+        Accounts.reserve(Items->size());
+        for (std::size_t I = 0; I < Items->size(); ++I) {
+          auto &Item = (*Items)[I];
+          std::ranges::transform(
+              Item.Name, Item.Name.begin(), [](unsigned char Ch) {
+                return std::tolower(Ch);
+              }
+          );
+          if (Item.Name.empty()) {
+            Output.Results[I] = {.Status = "invalid", .Error = "Empty name"};
+          }
+          Accounts.push_back({
+              .Name = Item.Name,
+              .Followers = Item.Followers.value_or(0),
+          });
+        }
+
+        respondBulk<models::Account>(
+            *Database,
+            Accounts,
+            Output,
+            [](const models::Account &Account) {
+              return std::pmr::string(Account.Name, core::requestResource());
+            },
+            [&](std::span<const models::Account> Accounts) {
+              recordAccounts(*State, Accounts);
+            },
+            "/accounts:bulk",
+            Request,
+            Response
+        );
       }
   );
 
   // Get Account by ID
   Router.get(
       "/accounts/:id",
-      [Database](const glz::request &Request, glz::response &Response) {
-        auto Id = Request.params.at("id");
-        spdlog::debug("GET /accounts/{} - Fetching account", Id);
-        auto Result = Database->get<github::models::Account>(Id);
-        if (!Result) {
-          spdlog::error(
-              "GET /accounts/{} - Database error: {}",
-              Id,
-              Result.error().Message
-          );
-          Response.status(static_cast<int>(InternalServerError))
-              .json({{"error", Result.error().Message}});
+      [Database, State](const glz::request &Request, glz::response &Response) {
+        auto Id = server::dependencies::uuidParam(Request);
+        if (!Id) {
+          core::respondError(Request, Response, BadRequest, Id.error().Message);
           return;
         }
-        spdlog::debug(
-            "GET /accounts/{} - Found account '{}'", Id, Result->Name
+        respondCached(
+            *State->Cache,
+            cache::accountKey(*Id),
+            Request,
+            Response,
+            [&](core::MediaType Format
+            ) -> std::expected<std::string_view, core::Error> {
+              spdlog::debug("GET /accounts/{} - Fetching account", *Id);
+              auto Result =
+                  findEntity<models::Account>(*Database, *State, *Id);
+              if (!Result) {
+                spdlog::error(
+                    "GET /accounts/{} - Database error: {}",
+                    *Id,
+                    Result.error().Message
+                );
+                return std::unexpected(Result.error());
+              }
+              spdlog::debug(
+                  "GET /accounts/{} - Found account '{}'",
+                  *Id,
+                  (*Result)->Name
+              );
+              return core::writeBody(Format, **Result);
+            }
         );
-        auto Output = OutputAccountSchema{
-            .Id = Result->Id,
-            .Name = Result->Name,
-            .Followers = Result->Followers,
-        };
-        Response.status(static_cast<int>(Ok)).json(Output);
-      },
-      {.constraints = {{"id", server::dependencies::uuidConstraint()}}}
+      }
   );
 
   // Soft Delete Account
   Router.del(
       "/accounts/:id",
-      [Database](const glz::request &Request, glz::response &Response) {
-        auto Id = Request.params.at("id");
-        spdlog::debug("DELETE /accounts/{} - Soft deleting account", Id);
-        auto Result = Database->remove<github::models::Account>(Id);
+      [Database, State](const glz::request &Request, glz::response &Response) {
+        auto Id = server::dependencies::uuidParam(Request);
+        if (!Id) {
+          core::respondError(Request, Response, BadRequest, Id.error().Message);
+          return;
+        }
+        spdlog::debug("DELETE /accounts/{} - Soft deleting account", *Id);
+        auto Result = Database->remove<github::models::Account>(*Id);
         if (!Result) {
           spdlog::error(
               "DELETE /accounts/{} - Database error: {}",
-              Id,
+              *Id,
               Result.error().Message
           );
-          Response.status(static_cast<int>(InternalServerError))
-              .json({{"error", Result.error().Message}});
+          core::respondError(
+              Request, Response, InternalServerError, Result.error().Message
+          );
           return;
         }
 
+        recordAccount(*State, *Result);
         spdlog::info(
-            "DELETE /accounts/{} - Deleted account '{}'", Id, Result->Name
+            "DELETE /accounts/{} - Deleted account '{}'", *Id, Result->Name
         );
-        auto Output = OutputAccountSchema{
-            .Id = Result->Id,
-            .Name = Result->Name,
-            .Followers = Result->Followers,
-        };
-        Response.status(static_cast<int>(Ok)).json(Output);
-      },
-      {.constraints = {{"id", server::dependencies::uuidConstraint()}}}
+        core::respond(Request, Response, Ok, *Result);
+      }
   );
   spdlog::debug("Registering github repos routes");
   // Get All Repos
   Router.get(
       "/repos",
-      [Database](const glz::request &Request, glz::response &Response) {
-        spdlog::debug("GET /repos - Fetching all repositories");
-        auto Result = Database->getAll<github::models::Repository>();
-
-        if (!Result) {
-          spdlog::error(
-              "GET /repos - Database error: {}", Result.error().Message
-          );
-          Response.status(static_cast<int>(InternalServerError))
-              .json({{"error", Result.error().Message}});
-          return;
-        }
+      [Database, State](const glz::request &Request, glz::response &Response) {
+        respondListRoute<models::Repository>(
+            *Database,
+            *State,
+            &Snapshot::Repositories,
+            cache::RepositoriesKey,
+            "/repos",
+            Request,
+            Response,
+            [&](core::MediaType Format
+            ) -> std::expected<std::string_view, core::Error> {
+              spdlog::debug("GET /repos - Fetching all repositories");
+              std::size_t Count = 0;
+              auto Result = writeEntities<models::Repository>(
+                  *Database, *State, &Snapshot::Repositories, Format, Count
+              );
 
-        spdlog::debug("GET /repos - Retrieved {} repositories", Result->size());
-        std::vector<github::OutputRepositorySchema> Output;
-        for (const auto &Repository : *Result) {
-          Output.emplace_back(
-              OutputRepositorySchema{
-                  .Id = Repository.Id,
-                  .Name = Repository.Name,
-                  .AccountId = Repository.AccountId,
-                  .Clones = Repository.Clones,
-                  .Forks = Repository.Forks,
-                  .Stars = Repository.Stars,
-                  .Subscribers = Repository.Subscribers,
-                  .Views = Repository.Views,
+              if (!Result) {
+                spdlog::error(
+                    "GET /repos - Database error: {}", Result.error().Message
+                );
+                return Result;
               }
-          );
-        }
 
-        Response.status(static_cast<int>(Ok)).json(Output);
+              spdlog::debug("GET /repos - Retrieved {} repositories", Count);
+              return Result;
+            }
+        );
       }
   );
 
   // Create Repo
   Router.post(
       "/repos",
-      [Database](const glz::request &Request, glz::response &Response) {
+      [Database, State](const glz::request &Request, glz::response &Response) {
         CreateRepositorySchema RepositoryData;
 
         if (auto JsonError =
                 glz::read<core::JsonOpts>(RepositoryData, Request.body)) {
           spdlog::warn("POST /repos - Invalid JSON in request body");
-          Response.status(static_cast<int>(BadRequest))
-              .json({{"error", "Invalid JSON"}});
+          core::respondError(Request, Response, BadRequest, "Invalid JSON");
           return;
         }
 
@@ -231,9 +991,19 @@ auto registerRoutes(
         spdlog::debug(
             "POST /repos - Creating repository '{}'", RepositoryData.Name
         );
+        auto AccountId = core::Uuid::parse(RepositoryData.AccountId);
+        if (!AccountId) {
+          spdlog::warn(
+              "POST /repos - Invalid AccountId '{}'", RepositoryData.AccountId
+          );
+          core::respondError(
+              Request, Response, BadRequest, "AccountId must be a UUID"
+          );
+          return;
+        }
         github::models::Repository RepositoryToCreate{
             .Name = RepositoryData.Name,
-            .AccountId = RepositoryData.AccountId,
+            .AccountId = *AccountId,
             .Clones = RepositoryData.Clones.value_or(0),
             .Forks = RepositoryData.Forks.value_or(0),
             .Stars = RepositoryData.Stars.value_or(0),
@@ -248,135 +1018,362 @@ auto registerRoutes(
               RepositoryData.Name,
               Result.error().Message
           );
-          Response.status(static_cast<int>(InternalServerError))
-              .json({{"error", Result.error().Message}});
+          core::respondError(
+              Request, Response, InternalServerError, Result.error().Message
+          );
           return;
         }
 
+        recordRepository(*State, *Result);
         spdlog::info(
             "POST /repos - Created repository '{}' with ID: {}",
             Result->Name,
             Result->Id
         );
-        auto Output = OutputRepositorySchema{
-            .Id = Result->Id,
-            .Name = Result->Name,
-            .AccountId = Result->AccountId,
-            .Clones = Result->Clones,
-            .Forks = Result->Forks,
-            .Stars = Result->Stars,
-            .Subscribers = Result->Subscribers,
-            .Views = Result->Views,
-        };
-        Response.status(static_cast<int>(Created)).json(Output);
+        core::respond(Request, Response, Created, *Result);
+      }
+  );
+
+  // Bulk Create Repos
+  Router.post(
+      "/repos:bulk",
+      [Database, State](const glz::request &Request, glz::response &Response) {
+        auto Items = readBulkBody<CreateRepositorySchema>(
+            "/repos:bulk", Request, Response
+        );
+        if (!Items) {
+          return;
+        }
+
+        // Reject unknown owners up front so one bad AccountId does not fail
+        // the whole statement on its foreign key.
+        auto Current = State->Snapshot->current();
+        BulkResponse Output;
+        Output.Results.resize(Items->size());
+        std::pmr::vector<models::Repository> Repositories(
+            core::requestResource()
+        );
+        Repositories.reserve(Items->size());
+        for (std::size_t I = 0; I < Items->size(); ++I) {
+          auto &Item = (*Items)[I];
+          std::ranges::transform(
+              Item.Name, Item.Name.begin(), [](unsigned char Ch) {
+                return std::tolower(Ch);
+              }
+          );
+          auto AccountId = core::Uuid::parse(Item.AccountId);
+          if (Item.Name.empty()) {
+            Output.Results[I] = {.Status = "invalid", .Error = "Empty name"};
+          } else if (!AccountId ||
+                     (Current && !Current->account(*AccountId))) {
+            Output.Results[I] = {
+                .Status = "invalid",
+                .Error = std::format("Unknown account '{}'", Item.AccountId),
+            };
+          }
+          Repositories.push_back({
+              .Name = Item.Name,
+              .AccountId = AccountId.value_or(core::Uuid{}),
+              .Clones = Item.Clones.value_or(0),
+              .Forks = Item.Forks.value_or(0),
+              .Stars = Item.Stars.value_or(0),
+              .Subscribers = Item.Subscribers.value_or(0),
+              .Views = Item.Views.value_or(0),
+          });
+        }
+
+        respondBulk<models::Repository>(
+            *Database,
+            Repositories,
+            Output,
+            [](const models::Repository &Repository) {
+              std::pmr::string Key(core::requestResource());
+              std::format_to(
+                  std::back_inserter(Key),
+                  "{}/{}",
+                  Repository.AccountId,
+                  Repository.Name
+              );
+              return Key;
+            },
+            [&](std::span<const models::Repository> Repositories) {
+              recordRepositories(*State, Repositories);
+            },
+            "/repos:bulk",
+            Request,
+            Response
+        );
       }
   );
 
   // Get Repo by ID
   Router.get(
       "/repos/:id",
-      [Database](const glz::request &Request, glz::response &Response) {
-        auto Id = Request.params.at("id");
-        spdlog::debug("GET /repos/{} - Fetching repository", Id);
-        auto Result = Database->get<github::models::Repository>(Id);
+      [Database, State](const glz::request &Request, glz::response &Response) {
+        auto Id = server::dependencies::uuidParam(Request);
+        if (!Id) {
+          core::respondError(Request, Response, BadRequest, Id.error().Message);
+          return;
+        }
+        respondCached(
+            *State->Cache,
+            cache::repositoryKey(*Id),
+            Request,
+            Response,
+            [&](core::MediaType Format
+            ) -> std::expected<std::string_view, core::Error> {
+              spdlog::debug("GET /repos/{} - Fetching repository", *Id);
+              auto Result =
+                  findEntity<models::Repository>(*Database, *State, *Id);
+              if (!Result) {
+                spdlog::error(
+                    "GET /repos/{} - Database error: {}",
+                    *Id,
+                    Result.error().Message
+                );
+                return std::unexpected(Result.error());
+              }
+              spdlog::debug(
+                  "GET /repos/{} - Found repository '{}'",
+                  *Id,
+                  (*Result)->Name
+              );
+              return core::writeBody(Format, **Result);
+            }
+        );
+      }
+  );
+
+  // Get Repo by owner/name: two probes into the snapshot's name index, no
+  // database round trip. The snapshot sees every write, so a miss is a 404.
+  Router.get(
+      "/repos/by-name/:owner/:name",
+      [Database, State](const glz::request &Request, glz::response &Response) {
+        const auto &Owner = Request.params.at("owner");
+        const auto &Name = Request.params.at("name");
+        spdlog::debug("GET /repos/by-name/{}/{} - Looking up", Owner, Name);
+
+        auto RespondNotFound = [&] {
+          core::respondError(
+              Request,
+              Response,
+              NotFound,
+              std::format("Repository '{}/{}' not found", Owner, Name)
+          );
+        };
+
+        if (auto Current = State->Snapshot->current()) {
+          const auto *Repository = Current->repositoryByName(Owner, Name);
+          if (Repository == nullptr) {
+            RespondNotFound();
+            return;
+          }
+          core::respond(Request, Response, Ok, *Repository);
+          return;
+        }
+
+        auto Result = readRepositoryByName(*Database, Owner, Name);
         if (!Result) {
           spdlog::error(
-              "GET /repos/{} - Database error: {}", Id, Result.error().Message
+              "GET /repos/by-name/{}/{} - Database error: {}",
+              Owner,
+              Name,
+              Result.error().Message
+          );
+          core::respondError(
+              Request, Response, InternalServerError, Result.error().Message
           );
-          Response.status(static_cast<int>(InternalServerError))
-              .json({{"error", Result.error().Message}});
           return;
         }
-        spdlog::debug(
-            "GET /repos/{} - Found repository '{}'", Id, Result->Name
-        );
-        auto Output = OutputRepositorySchema{
-            .Id = Result->Id,
-            .Name = Result->Name,
-            .AccountId = Result->AccountId,
-            .Clones = Result->Clones,
-            .Forks = Result->Forks,
-            .Stars = Result->Stars,
-            .Views = Result->Views,
-        };
-        Response.status(static_cast<int>(Ok)).json(Output);
-      },
-      {.constraints = {{"id", server::dependencies::uuidConstraint()}}}
+        if (!*Result) {
+          RespondNotFound();
+          return;
+        }
+        core::respond(Request, Response, Ok, **Result);
+      }
   );
 
   // Soft Delete Repo
   Router.del(
       "/repos/:id",
-      [Database](const glz::request &Request, glz::response &Response) {
-        auto Id = Request.params.at("id");
-        spdlog::debug("DELETE /repos/{} - Soft deleting repository", Id);
-        auto Result = Database->remove<github::models::Repository>(Id);
+      [Database, State](const glz::request &Request, glz::response &Response) {
+        auto Id = server::dependencies::uuidParam(Request);
+        if (!Id) {
+          core::respondError(Request, Response, BadRequest, Id.error().Message);
+          return;
+        }
+        spdlog::debug("DELETE /repos/{} - Soft deleting repository", *Id);
+        auto Result = Database->remove<github::models::Repository>(*Id);
 
         if (!Result) {
           spdlog::error(
               "DELETE /repos/{} - Database error: {}",
-              Id,
+              *Id,
               Result.error().Message
           );
-          Response.status(static_cast<int>(InternalServerError))
-              .json({{"error", Result.error().Message}});
+          core::respondError(
+              Request, Response, InternalServerError, Result.error().Message
+          );
           return;
         }
 
+        recordRepository(*State, *Result);
         spdlog::info(
-            "DELETE /repos/{} - Deleted repository '{}'", Id, Result->Name
+            "DELETE /repos/{} - Deleted repository '{}'", *Id, Result->Name
         );
-        auto Output = OutputRepositorySchema{
-            .Id = Result->Id,
-            .Name = Result->Name,
-            .AccountId = Result->AccountId,
-            .Clones = Result->Clones,
-            .Forks = Result->Forks,
-            .Stars = Result->Stars,
-            .Views = Result->Views,
-        };
-        Response.status(static_cast<int>(Ok)).json(Output);
-      },
-      {.constraints = {{"id", server::dependencies::uuidConstraint()}}}
+        core::respond(Request, Response, Ok, *Result);
+      }
   );
 
   // Admin Sync Repo by ID
   Router.post(
       "/repos/:id/sync",
-      [Database, Config](const glz::request &Request, glz::response &Response) {
-        auto Id = Request.params.at("id");
-        spdlog::debug("POST /repos/{}/sync - Syncing repository", Id);
-        auto Result =
-            github::tasks::syncRepositoryById(Id, *Database, Config);
+      [Database, State, Config](
+          const glz::request &Request, glz::response &Response
+      ) {
+        auto Id = server::dependencies::uuidParam(Request);
+        if (!Id) {
+          core::respondError(Request, Response, BadRequest, Id.error().Message);
+          return;
+        }
+        spdlog::debug("POST /repos/{}/sync - Syncing repository", *Id);
+        auto Result = github::tasks::syncRepositoryById(
+            *Id, *Database, Config, makeSyncHooks(State)
+        );
         if (!Result) {
           spdlog::error(
               "POST /repos/{}/sync - Sync failed: {}",
-              Id,
+              *Id,
               Result.error().Message
           );
-          Response.status(static_cast<int>(InternalServerError))
-              .json({{"error", Result.error().Message}});
+          core::respondError(
+              Request, Response, InternalServerError, Result.error().Message
+          );
           return;
         }
 
         auto Output = SyncRepositoryResponse{
             .Status = "success",
-            .Summary = std::format("Repository {} synced successfully.", Id),
-            .Repository =
-                OutputRepositorySchema{
-                    .Id = Result->Id,
-                    .Name = Result->Name,
-                    .AccountId = Result->AccountId,
-                    .Clones = Result->Clones,
-                    .Forks = Result->Forks,
-                    .Stars = Result->Stars,
-                    .Subscribers = Result->Subscribers,
-                    .Views = Result->Views,
-                },
+            .Summary = std::format("Repository {} synced successfully.", *Id),
+            .Repository = toOutput(*Result),
         };
-        Response.status(static_cast<int>(Ok)).json(Output);
-      },
-      {.constraints = {{"id", server::dependencies::uuidConstraint()}}}
+        core::respond(Request, Response, Ok, Output);
+      }
+  );
+
+  // Search by name, for type-ahead: prefix and fuzzy matches from the
+  // in-memory search index, falling back to a prefix query on the database
+  // until the index is loaded.
+  Router.get(
+      "/search",
+      [Database, State](const glz::request &Request, glz::response &Response) {
+        auto Query = core::queryParam(Request, "q");
+        if (!Query || Query->empty()) {
+          core::respondError(
+              Request, Response, BadRequest, "Parameter 'q' is required"
+          );
+          return;
+        }
+        if (Query->size() > MaxSearchQueryLength) {
+          core::respondError(
+              Request,
+              Response,
+              BadRequest,
+              std::format(
+                  "Parameter 'q' must be at most {} characters",
+                  MaxSearchQueryLength
+              )
+          );
+          return;
+        }
+
+        auto Limit = DefaultSearchLimit;
+        if (auto Value = core::queryParam(Request, "limit")) {
+          std::size_t Number = 0;
+          auto [End, Ec] = std::from_chars(
+              Value->data(), Value->data() + Value->size(), Number
+          );
+          if (Ec != std::errc{} ||
+              End != Value->data() + Value->size() || Number < 1 ||
+              Number > MaxSearchLimit) {
+            core::respondError(
+                Request,
+                Response,
+                BadRequest,
+                std::format(
+                    "Parameter 'limit' must be in [1, {}]", MaxSearchLimit
+                )
+            );
+            return;
+          }
+          Limit = Number;
+        }
+        spdlog::debug("GET /search - Searching for '{}'", *Query);
+
+        std::optional<SearchResults> Found;
+        if (State->Search) {
+          Found = State->Search->search(*Query, Limit);
+        }
+        if (!Found) {
+          auto FromDatabase = searchDatabase(*Database, *Query, Limit);
+          if (!FromDatabase) {
+            spdlog::error(
+                "GET /search - Database error: {}",
+                FromDatabase.error().Message
+            );
+            core::respondError(
+                Request,
+                Response,
+                InternalServerError,
+                FromDatabase.error().Message
+            );
+            return;
+          }
+          Found = std::move(*FromDatabase);
+        }
+
+        SearchResponse Output{.Query = std::move(*Query)};
+        Output.Repositories.reserve(Found->Repositories.size());
+        for (const auto &Repository : Found->Repositories) {
+          Output.Repositories.push_back(toOutput(*Repository));
+        }
+        Output.Accounts.reserve(Found->Accounts.size());
+        for (const auto &Account : Found->Accounts) {
+          Output.Accounts.push_back(toOutput(*Account));
+        }
+        core::respond(Request, Response, Ok, Output);
+      }
+  );
+
+  // Aggregate Stats
+  Router.get(
+      "/stats", [State](const glz::request &Request, glz::response &Response) {
+        spdlog::debug("GET /stats - Reading aggregate counters");
+        if (!State->Stats) {
+          core::respondError(
+              Request, Response, InternalServerError, "Stats are not enabled"
+          );
+          return;
+        }
+        auto View = State->Stats->view();
+        StatsResponse Output{
+            .Totals = View.Totals,
+            .ReconciledAt = std::move(View.ReconciledAt),
+        };
+        Output.Accounts.reserve(View.Accounts.size());
+        for (const auto &[AccountId, Counters] : View.Accounts) {
+          Output.Accounts.push_back({
+              .AccountId = AccountId,
+              .Repositories = Counters.Repositories,
+              .Stars = Counters.Stars,
+              .Forks = Counters.Forks,
+              .Views = Counters.Views,
+              .Clones = Counters.Clones,
+              .Followers = Counters.Followers,
+          });
+        }
+        core::respond(Request, Response, Ok, Output);
+      }
   );
 
   spdlog::info("Successfully registered all github routes");
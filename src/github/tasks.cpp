@@ -18,6 +18,7 @@
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <utility>
 
 namespace insights::github::tasks {
 
@@ -42,7 +43,8 @@ static auto syncRepository(
     std::shared_ptr<glz::http_client> Client,
     db::Database &Database,
     const core::Config &Config,
-    github::models::Repository Repository
+    github::models::Repository Repository,
+    const SyncHooks &Hooks
 ) -> std::expected<github::models::Repository, core::Error> {
   if (!Client) {
     Log()->error("HTTP Client is null");
@@ -129,9 +131,17 @@ static auto syncRepository(
 
   Repository.Views += TrafficStats.count;
 
-  if (auto Result = Database.update(Repository); !Result) {
+  // Report the row the update returned, not the copy read before the
+  // fetch: a soft delete that landed in between must not be undone in the
+  // read state.
+  auto Result = Database.update(Repository);
+  if (!Result) {
     return std::unexpected(Result.error());
   }
+  Repository = std::move(*Result);
+  if (Hooks.OnRepositoryCommitted) {
+    Hooks.OnRepositoryCommitted(Repository);
+  }
 
   Log()->info(
       "Repo: ID: {}, Name: {}, AccountId: {}, Clones: {}, Forks: {}, "
@@ -152,7 +162,8 @@ static auto syncRepository(
 auto updateRepositories(
     std::shared_ptr<glz::http_client> Client,
     db::Database &Database,
-    const core::Config &Config
+    const core::Config &Config,
+    const SyncHooks &Hooks
 ) -> std::expected<SyncEntityStats, core::Error> {
   SyncEntityStats StepStats;
 
@@ -163,7 +174,7 @@ auto updateRepositories(
   }
 
   for (auto &Repository : *Repositories) {
-    auto Result = syncRepository(Client, Database, Config, Repository);
+    auto Result = syncRepository(Client, Database, Config, Repository, Hooks);
     if (!Result) {
       ++StepStats.Failed;
       Log()->error(
@@ -181,7 +192,8 @@ auto updateRepositories(
 auto updateAccounts(
     std::shared_ptr<glz::http_client> Client,
     db::Database &Database,
-    const core::Config &Config
+    const core::Config &Config,
+    const SyncHooks &Hooks
 ) -> std::expected<SyncEntityStats, core::Error> {
   SyncEntityStats StepStats;
   // Set Headers
@@ -243,7 +255,8 @@ auto updateAccounts(
             Account.Name,
             Account.Followers
         );
-    if (auto Result = Database.update(Account); !Result) {
+    auto Result = Database.update(Account);
+    if (!Result) {
       ++StepStats.Failed;
       spdlog::get("github_sync")
           ->error(
@@ -251,12 +264,16 @@ auto updateAccounts(
           );
       continue;
     }
+    if (Hooks.OnAccountCommitted) {
+      Hooks.OnAccountCommitted(*Result);
+    }
     ++StepStats.Processed;
   }
   return StepStats;
 }
 
-auto syncStats(const core::Config &Config) -> std::expected<void, core::Error> {
+auto syncStats(const core::Config &Config, const SyncHooks &Hooks)
+    -> std::expected<void, core::Error> {
   // Open a fresh connection for this run — closed automatically at scope exit.
   auto DatabaseResult = db::Database::connect(Config.DatabaseUrl);
   if (!DatabaseResult) {
@@ -336,14 +353,14 @@ auto syncStats(const core::Config &Config) -> std::expected<void, core::Error> {
   auto Client = *ClientResult;
 
   // Run the pipeline in order: Repos → Accounts
-  auto RepoResult = updateRepositories(Client, Database, Config);
+  auto RepoResult = updateRepositories(Client, Database, Config, Hooks);
   if (!RepoResult) {
     finishAttempt("failed", RepoResult.error().Message);
     return std::unexpected(RepoResult.error());
   }
   RunStats.Repositories = *RepoResult;
 
-  auto AccountResult = updateAccounts(Client, Database, Config);
+  auto AccountResult = updateAccounts(Client, Database, Config, Hooks);
   if (!AccountResult) {
     finishAttempt("failed", AccountResult.error().Message);
     return std::unexpected(AccountResult.error());
@@ -381,9 +398,10 @@ auto syncStats(const core::Config &Config) -> std::expected<void, core::Error> {
 }
 
 auto syncRepositoryById(
-    std::string_view RepositoryId,
+    const core::Uuid &RepositoryId,
     db::Database &Database,
-    const core::Config &Config
+    const core::Config &Config,
+    const SyncHooks &Hooks
 ) -> std::expected<github::models::Repository, core::Error> {
   auto Repository = Database.get<github::models::Repository>(RepositoryId);
   if (!Repository) {
@@ -395,7 +413,9 @@ auto syncRepositoryById(
     return std::unexpected(ClientResult.error());
   }
 
-  return syncRepository(*ClientResult, Database, Config, *Repository);
+  return syncRepository(
+      *ClientResult, Database, Config, *Repository, Hooks
+  );
 }
 
 } // namespace insights::github::tasks
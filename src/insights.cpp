@@ -1,11 +1,10 @@
 #include "insights/core/config.hpp"
 #include "insights/core/logging.hpp"
-#include "insights/core/routes.hpp"
 #include "insights/core/scheduler.hpp"
 #include "insights/db/db.hpp"
 #include "insights/github/routes.hpp"
 #include "insights/github/tasks.hpp"
-#include "insights/server/middleware/logging.hpp"
+#include "insights/server/server.hpp"
 
 #include "spdlog/spdlog.h"
 
@@ -13,83 +12,33 @@
 #include <asio/io_context.hpp>
 #include <asio/signal_set.hpp>
 #include <asio/steady_timer.hpp>
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
 #include <functional>
-#include <glaze/net/http_router.hpp>
-#include <glaze/net/http_server.hpp>
 #include <insights/core/timestamp.hpp>
 #include <memory>
+#include <mutex>
+#include <stop_token>
 #include <string_view>
 #include <system_error>
 #include <thread>
 
-int main() {
-  // Use ASIO IO Context for background tasks.
-  auto IOContext = std::make_shared<asio::io_context>();
-
-  // Pull Environment Variables.
-  auto Config = insights::core::Config::load();
-  if (!Config) {
-    spdlog::error(Config.error().Message);
-    return 1;
-  }
-
-  // Configure logging — server logger becomes default, one file per component
-  insights::core::setupLogging(*Config);
-  insights::core::createLogger("github_sync", *Config);
-
-  spdlog::debug(
-      "Loaded config - Host: {}, Port: {}", Config->Host, Config->Port
-  );
-
-  // Initialize Insights HTTP Server
-  auto Server{glz::http_server<false>(IOContext)};
-
-  spdlog::info("🧊ICICLE Insights Server🧊");
-  Server.bind(Config->Host, Config->Port);
-  spdlog::info("Binding to Address: {}, Port: {}.", Config->Host, Config->Port);
-
-  // Register Middleware
-  Server.wrap(insights::server::middleware::createLoggingMiddleware());
-
-  // Register Sever Database Connection
-  spdlog::info("Connecting to database.");
-  auto ServerDatabase = insights::db::Database::connect(Config->DatabaseUrl);
-  if (!ServerDatabase) {
-    spdlog::error(ServerDatabase.error().Message);
-    return 1;
-  }
-
-  // Register Routes
-  glz::http_router Router;
-  spdlog::info("Registering routes:");
-  insights::core::registerCoreRoutes(Router, ServerDatabase.value());
-  spdlog::info("GitHubRoutes");
-  glz::http_router GitHubRouter;
-
-  if (!insights::github::registerRoutes(
-          GitHubRouter, ServerDatabase.value(), *Config
-      )) {
-    spdlog::error("Failed registering git routes.");
-  }
-
-  // Mount the routers
-  Server.mount("/", Router);
-  Server.mount("/api/github", GitHubRouter);
-
-  // Start The Server (0 Worker Threads so we can run with ASIO shared IO
-  // Context)
-  Server.start(0);
-
-  // Tasks
-
-  // GitHub Metrics Sync Task
+namespace {
 
+// GitHub Metrics Sync Task
+void scheduleGitHubSync(
+    asio::io_context &IOContext,
+    insights::db::Database &Database,
+    const insights::core::Config &Config,
+    std::shared_ptr<insights::github::ReadState> GitHubState
+) {
   // Query DB for seconds until the next scheduled run.
   // Returns nullopt on first-ever run (no row yet); negative if overdue.
-  auto SyncInterval =
-      std::chrono::duration_cast<std::chrono::seconds>(std::chrono::weeks(2));
-  auto DelayResult = ServerDatabase.value()->querySecondsUntilNextRun(
+  auto SyncInterval = std::chrono::duration_cast<std::chrono::seconds>(
+      std::chrono::weeks(2)
+  );
+  auto DelayResult = Database.querySecondsUntilNextRun(
       "GitHubSync", SyncInterval
   );
   if (!DelayResult) {
@@ -97,7 +46,7 @@ int main() {
         "Failed to query next GitHubSync run time: {}",
         DelayResult.error().Message
     );
-    return 1;
+    return;
   }
 
   auto SecondsUntilNext =
@@ -120,7 +69,7 @@ int main() {
   }
 
   // Set Task Timer
-  auto GitHubSyncTimer = std::make_shared<asio::steady_timer>(*IOContext);
+  auto GitHubSyncTimer = std::make_shared<asio::steady_timer>(IOContext);
 
   // Schedule the task
   spdlog::info(
@@ -134,16 +83,101 @@ int main() {
       "GitHubSync",
       InitialDelay,
       std::chrono::weeks(2),
-      [Config] {
-        auto Result = insights::github::tasks::syncStats(*Config);
+      [Config, SyncHooks = insights::github::makeSyncHooks(GitHubState)] {
+        auto Result = insights::github::tasks::syncStats(Config, SyncHooks);
         if (!Result) {
           spdlog::get("github_sync")
               ->error("GitHubSync failed: {}", Result.error().Message);
         } else {
-          spdlog::get("github_sync")->info("GitHubSync finished successfully.");
+          spdlog::get("github_sync")
+              ->info("GitHubSync finished successfully.");
         }
       }
   );
+}
+
+} // namespace
+
+int main() {
+  // Startup timings (/ready, logs) are measured from here.
+  auto Started = std::chrono::steady_clock::now();
+
+  // Use ASIO IO Context for background tasks.
+  auto IOContext = std::make_shared<asio::io_context>();
+
+  // Pull Environment Variables.
+  auto Config = insights::core::Config::load();
+  if (!Config) {
+    spdlog::error(Config.error().Message);
+    return 1;
+  }
+
+  // Configure logging — server logger becomes default, one file per component
+  insights::core::setupLogging(*Config);
+  insights::core::createLogger("github_sync", *Config);
+
+  spdlog::debug(
+      "Loaded config - Host: {}, Port: {}", Config->Host, Config->Port
+  );
+
+  // Initialize Insights HTTP Server
+  spdlog::info("🧊ICICLE Insights Server🧊");
+  auto App =
+      insights::server::createApp(IOContext, *Config, {.Started = Started});
+  if (!App) {
+    spdlog::error(App.error().Message);
+    return 1;
+  }
+  auto &Server = (*App)->Server;
+  auto &ServerDatabase = (*App)->Database;
+  auto &GitHubState = (*App)->GitHubState;
+
+  Server.bind(Config->Host, Config->Port);
+  spdlog::info("Binding to Address: {}, Port: {}.", Config->Host, Config->Port);
+
+  // Start The Server (0 Worker Threads so we can run with ASIO shared IO
+  // Context)
+  Server.start(0);
+  (*App)->Startup->listening();
+
+  // Warm up off the server threads: the listener already answers probes
+  // (and 503 for everything else) while the database connects. An
+  // unreachable database is retried with backoff instead of exiting.
+  std::jthread WarmUp([&](std::stop_token Stop) {
+    for (int Attempt = 0;; ++Attempt) {
+      auto Warm = insights::server::warmUp(**App, *Config);
+      if (Warm) {
+        break;
+      }
+      if (Stop.stop_requested()) {
+        return;
+      }
+      auto Delay = std::chrono::seconds(
+          std::min(1LL << std::min(Attempt, 5), 30LL)
+      );
+      spdlog::warn(
+          "Startup failed (attempt {}), retrying in {}s: {}",
+          Attempt + 1,
+          Delay.count(),
+          Warm.error().Message
+      );
+      std::mutex Mutex;
+      std::condition_variable_any Wake;
+      std::unique_lock Lock(Mutex);
+      Wake.wait_for(Lock, Stop, Delay, [] { return false; });
+      if (Stop.stop_requested()) {
+        return;
+      }
+    }
+
+    // Disabled with GITHUB_SYNC_ENABLED=0, e.g. for load tests and PGO
+    // training runs that must not call the GitHub API.
+    if (!Config->GitHubSyncEnabled) {
+      spdlog::info("GitHubSync disabled by GITHUB_SYNC_ENABLED.");
+      return;
+    }
+    scheduleGitHubSync(*IOContext, *ServerDatabase, *Config, GitHubState);
+  });
 
   // Start All Threads (Server + Tasks)
   // Start the Thread pool.
@@ -152,7 +186,9 @@ int main() {
   Threads.reserve(NumThreads);
 
   spdlog::info(
-      "Server ready and listening on http://{}:{}", Config->Host, Config->Port
+      "Listening on http://{}:{}, ready once warmed up (GET /ready).",
+      Config->Host,
+      Config->Port
   );
 
   spdlog::info("Sharing {} threads.", NumThreads);
@@ -160,9 +196,9 @@ int main() {
   asio::signal_set Signals(*IOContext, SIGINT, SIGTERM);
   Signals.async_wait([&](const std::error_code &, int) {
     spdlog::info("Shutdown signal received.");
+    WarmUp.request_stop();
     Server.stop();
     IOContext->stop();
-    spdlog::shutdown();
   });
 
   for (auto _ : std::views::iota(0uz, NumThreads)) {
@@ -175,5 +211,12 @@ int main() {
     }
   }
 
+  // Every thread that logs is stopped before the loggers are torn down;
+  // the access log writes out what it still holds on the way.
+  WarmUp.join();
+  (*App)->AccessLog->stop();
+  GitHubState->Stats->stopReconciliation();
+  spdlog::shutdown();
+
   return 0;
 }
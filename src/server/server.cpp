@@ -0,0 +1,333 @@
+#include "insights/server/server.hpp"
+
+#include "insights/core/batch.hpp"
+#include "insights/core/routes.hpp"
+#include "insights/github/live.hpp"
+#include "insights/github/routes.hpp"
+#include "insights/github/search.hpp"
+#include "insights/github/snapshot.hpp"
+#include "insights/github/stats.hpp"
+#include "insights/server/middleware/arena.hpp"
+#include "insights/server/middleware/logging.hpp"
+#include "insights/server/middleware/readiness.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <asio/steady_timer.hpp>
+#include <chrono>
+#include <format>
+#include <future>
+#include <numeric>
+
+namespace insights::server {
+
+std::expected<std::unique_ptr<App>, core::Error> createApp(
+    std::shared_ptr<asio::io_context> IOContext,
+    const core::Config &Config,
+    AppOptions Options
+) {
+  auto Self = std::make_unique<App>(IOContext);
+  auto &Server = Self->Server;
+  auto Startup = std::make_shared<core::Startup>(Options.Started);
+
+  // Register Middleware
+  auto Metrics = std::make_shared<core::Metrics>();
+  auto AccessLog = std::make_shared<core::AccessLog>(core::AccessLogOptions{
+      .SampleRate = Config.AccessLogSampleRate,
+      .SlowThreshold = std::chrono::milliseconds(Config.AccessLogSlowMs),
+  });
+  Metrics->addCallback(
+      "insights_access_log_dropped_total",
+      "Access log entries dropped because the queue was full.",
+      "counter",
+      [AccessLog] { return static_cast<double>(AccessLog->dropped()); }
+  );
+  Server.wrap(middleware::createLoggingMiddleware(Metrics, AccessLog));
+
+  // Connection lifecycle: cap open keep-alive connections, advertise and
+  // enforce the idle timeout and recycle long-lived ones (see
+  // ConnectionTracker).
+  auto Connections = std::make_shared<middleware::ConnectionTracker>(
+      middleware::ConnectionLimits{
+          .MaxConnections = Config.MaxConnections,
+          .IdleTimeout = std::chrono::seconds(Config.ConnectionIdleTimeoutS),
+          .MaxRequestsPerConnection = Config.MaxRequestsPerConnection,
+      }
+  );
+  Server.wrap(middleware::createConnectionMiddleware(Connections));
+  middleware::startConnectionSweep(
+      std::make_shared<asio::steady_timer>(*IOContext), Connections
+  );
+  Metrics->addCallback(
+      "insights_connections_open",
+      "Keep-alive connections currently counted against MAX_CONNECTIONS.",
+      "gauge",
+      [Connections] {
+        return static_cast<double>(Connections->stats().Open);
+      }
+  );
+  Metrics->addCallback(
+      "insights_connections_idle",
+      "Connections past CONNECTION_IDLE_TIMEOUT_S not yet seen again.",
+      "gauge",
+      [Connections] {
+        return static_cast<double>(Connections->stats().Idle);
+      }
+  );
+  Metrics->addCallback(
+      "insights_connections_rejected_total",
+      "New connections refused because MAX_CONNECTIONS was reached.",
+      "counter",
+      [Connections] {
+        return static_cast<double>(Connections->stats().Rejected);
+      }
+  );
+  Metrics->addCallback(
+      "insights_connections_closed_idle_total",
+      "Idle connections closed when they sent another request.",
+      "counter",
+      [Connections] {
+        return static_cast<double>(Connections->stats().ClosedIdle);
+      }
+  );
+  Metrics->addCallback(
+      "insights_connections_closed_max_requests_total",
+      "Connections closed after MAX_REQUESTS_PER_CONNECTION requests.",
+      "counter",
+      [Connections] {
+        return static_cast<double>(Connections->stats().ClosedMaxRequests);
+      }
+  );
+  Metrics->addCallback(
+      "insights_connections_reclaimed_total",
+      "Silent connections stopped counting towards MAX_CONNECTIONS at the cap.",
+      "counter",
+      [Connections] {
+        return static_cast<double>(Connections->stats().Reclaimed);
+      }
+  );
+
+  // Per-client token buckets (by remote address), per route class, from
+  // the RATE_LIMIT_* settings.
+  auto RateLimiter =
+      std::make_shared<middleware::RateLimiter>(middleware::RateLimits{
+          .Read = {.Burst = Config.RateLimitReadBurst,
+                   .PerSecond = Config.RateLimitReadPerS},
+          .Write = {.Burst = Config.RateLimitWriteBurst,
+                    .PerSecond = Config.RateLimitWritePerS},
+          .Expensive = {.Burst = Config.RateLimitExpensiveBurst,
+                        .PerSecond = Config.RateLimitExpensivePerS},
+      });
+  Server.wrap(middleware::createRateLimitMiddleware(RateLimiter));
+  Metrics->addCallback(
+      "insights_rate_limited_total",
+      "Requests answered 429 by the per-client rate limiter.",
+      "counter",
+      [RateLimiter] {
+        return static_cast<double>(RateLimiter->stats().Limited);
+      }
+  );
+  middleware::startRateLimitEviction(
+      std::make_shared<asio::steady_timer>(*IOContext), RateLimiter
+  );
+
+  // Until warmUp() has connected the database and loaded the read state,
+  // only the probe routes are served.
+  Server.wrap(middleware::createReadinessMiddleware(Startup));
+
+  // Shed load before it queues: the io_context queue delay, sampled by a
+  // timer on the shared context, plus a cap on expensive requests.
+  auto Admission = std::make_shared<middleware::AdmissionController>(
+      Options.AdmissionLimits
+  );
+  Server.wrap(middleware::createAdmissionMiddleware(Admission));
+  middleware::startQueueDelayProbe(
+      std::make_shared<asio::steady_timer>(*IOContext), Admission
+  );
+  Metrics->addCallback(
+      "insights_admission_shed_total",
+      "Requests answered 503 by admission control (all route classes).",
+      "counter",
+      [Admission] {
+        auto Shed = Admission->stats().Shed;
+        return static_cast<double>(
+            std::accumulate(Shed.begin(), Shed.end(), uint64_t{0})
+        );
+      }
+  );
+  Metrics->addCallback(
+      "insights_admission_queue_delay_seconds",
+      "Latest io_context queue delay measured by the admission probe.",
+      "gauge",
+      [Admission] {
+        return std::chrono::duration<double>(Admission->queueDelay()).count();
+      }
+  );
+
+  // Innermost: a request-scoped arena for handler temporaries, only for
+  // requests that were admitted.
+  Server.wrap(middleware::createArenaMiddleware());
+
+  // Register Sever Database Connection. It connects in warmUp(), after the
+  // listener is up.
+  auto Database = std::make_shared<db::Database>(
+      Config.DatabaseUrl, db::Database::DeferConnect{}
+  );
+
+  // In-memory read state shared by the github routes: an entity snapshot,
+  // a response cache, aggregate counters, the name search index and the
+  // live push hub, all kept current by every write path and by the GitHub
+  // sync as it commits.
+  auto ResponseCache = std::make_shared<core::ResponseCache>();
+  auto Snapshot = std::make_shared<github::SnapshotStore>();
+  auto LiveHub = std::make_shared<github::LiveHub>(Snapshot);
+  auto GitHubState = std::make_shared<github::ReadState>(github::ReadState{
+      .Cache = ResponseCache,
+      .Snapshot = Snapshot,
+      .Stats = std::make_shared<github::StatsStore>(),
+      .Search = std::make_shared<github::SearchIndex>(),
+      .Live = LiveHub,
+  });
+
+  // Register Routes
+  auto &Router = Self->Router;
+  auto &GitHubRouter = Self->GitHubRouter;
+  spdlog::info("Registering routes:");
+  core::registerCoreRoutes(Router, Database, ResponseCache, Metrics, Startup);
+  spdlog::info("GitHubRoutes");
+  if (!github::registerRoutes(GitHubRouter, Database, GitHubState, Config)) {
+    spdlog::error("Failed registering git routes.");
+  }
+
+  // POST /batch dispatches into the same routers, with the same prefixes
+  // they are mounted under below.
+  core::registerBatchRoute(
+      Router,
+      {{.Prefix = "/", .Router = &Router},
+       {.Prefix = "/api/github", .Router = &GitHubRouter}}
+  );
+
+  // Mount the routers
+  Server.mount("/", Router);
+  Server.mount("/api/github", GitHubRouter);
+  Metrics->addRoutes("/", Router);
+  Metrics->addRoutes("/api/github", GitHubRouter);
+
+  // Live entity deltas over WebSocket, flushed on the shared io_context.
+  Server.websocket("/api/github/live", github::createLiveServer(LiveHub));
+  github::startLiveFlush(
+      std::make_shared<asio::steady_timer>(*IOContext), LiveHub
+  );
+  Metrics->addCallback(
+      "insights_live_subscribers",
+      "Open live WebSocket connections.",
+      "gauge",
+      [LiveHub] { return static_cast<double>(LiveHub->stats().Subscribers); }
+  );
+  Metrics->addCallback(
+      "insights_live_frames_total",
+      "Live frames serialized (one per topic per flush with changes).",
+      "counter",
+      [LiveHub] { return static_cast<double>(LiveHub->stats().Frames); }
+  );
+  Metrics->addCallback(
+      "insights_live_sends_total",
+      "Live frames queued to subscribers.",
+      "counter",
+      [LiveHub] { return static_cast<double>(LiveHub->stats().Sends); }
+  );
+
+  Metrics->addCallback(
+      "insights_ready",
+      "1 once the database is connected and the read state is loaded.",
+      "gauge",
+      [Startup] { return Startup->isReady() ? 1.0 : 0.0; }
+  );
+  Metrics->addCallback(
+      "insights_startup_ready_seconds",
+      "Seconds from process start until ready (0 while warming up).",
+      "gauge",
+      [Startup] { return Startup->report().ReadyMs.value_or(0.0) / 1000.0; }
+  );
+  Metrics->addCallback(
+      "insights_startup_first_request_seconds",
+      "Seconds from process start until the first request was served.",
+      "gauge",
+      [Startup] {
+        return Startup->report().FirstRequestMs.value_or(0.0) / 1000.0;
+      }
+  );
+
+  Self->Metrics = std::move(Metrics);
+  Self->AccessLog = std::move(AccessLog);
+  Self->Connections = std::move(Connections);
+  Self->RateLimiter = std::move(RateLimiter);
+  Self->Admission = std::move(Admission);
+  Self->Startup = std::move(Startup);
+  Self->Database = std::move(Database);
+  Self->GitHubState = std::move(GitHubState);
+  return Self;
+}
+
+std::expected<void, core::Error>
+warmUp(App &Self, const core::Config &Config) {
+  using Clock = core::Startup::Clock;
+  auto &Startup = *Self.Startup;
+  if (Startup.isReady()) {
+    return {};
+  }
+
+  auto Began = Clock::now();
+  if (auto Opened = Self.Database->open(); !Opened) {
+    Startup.failed(Opened.error().Message);
+    return std::unexpected(Opened.error());
+  }
+  Startup.step("database", Clock::now() - Began);
+
+  // The two loads are independent. The stats query gets its own short-lived
+  // connection so it does not queue behind the snapshot on the shared one.
+  auto &State = *Self.GitHubState;
+  auto StatsLoaded = std::async(std::launch::async, [&] {
+    auto StatsBegan = Clock::now();
+    auto Connection = db::Database::connect(Config.DatabaseUrl);
+    if (!Connection) {
+      return std::expected<void, core::Error>(
+          std::unexpected(Connection.error())
+      );
+    }
+    auto Loaded = State.Stats->load(**Connection);
+    Startup.step("stats", Clock::now() - StatsBegan);
+    return Loaded;
+  });
+
+  // Without the snapshot every read would go to the database, so the app
+  // stays not ready and the caller retries the whole warm-up with backoff.
+  Began = Clock::now();
+  if (auto Loaded = State.Snapshot->load(*Self.Database); !Loaded) {
+    StatsLoaded.wait();
+    auto Error = core::Error{std::format(
+        "Failed to load github snapshot: {}", Loaded.error().Message
+    )};
+    Startup.failed(Error.Message);
+    return std::unexpected(std::move(Error));
+  }
+  Startup.step("snapshot", Clock::now() - Began);
+
+  Began = Clock::now();
+  if (State.Search->load(*State.Snapshot)) {
+    Startup.step("search", Clock::now() - Began);
+  }
+
+  if (auto Loaded = StatsLoaded.get(); !Loaded) {
+    spdlog::warn(
+        "Failed to load github stats, retrying at the next reconciliation: {}",
+        Loaded.error().Message
+    );
+  }
+  State.Stats->startReconciliation(Config.DatabaseUrl);
+
+  spdlog::info("Ready {:.1f}ms after start.", Startup.ready());
+  return {};
+}
+
+} // namespace insights::server